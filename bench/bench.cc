@@ -0,0 +1,300 @@
+#include "bench.h"
+#include "core/kernel.h"
+#include "core/plan.h"
+#include "utils/data_generator.h"
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <fcntl.h>
+#include <thread>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace infini
+{
+    vector<Benchmark> &getBenchmarks()
+    {
+        static vector<Benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    bool addBenchmark(const string &name,
+                      std::function<Operator(GraphObj &)> build)
+    {
+        getBenchmarks().push_back({name, std::move(build)});
+        return true;
+    }
+
+    string shapeName(const Shape &shape)
+    {
+        string ret;
+        for (size_t i = 0; i < shape.size(); ++i)
+            ret += (i ? "x" : "") + std::to_string(shape[i]);
+        return ret;
+    }
+
+    namespace
+    {
+        constexpr size_t MinIterations = 3;
+
+        struct Options
+        {
+            std::regex filter{"."};
+            double minTime = 0.2; // seconds per benchmark
+            string out;           // JSON report
+            bool list = false;
+        };
+
+        struct Result
+        {
+            string name;
+            size_t iterations;
+            double medianTime, minTime; // seconds per run
+            double bytes, flops;        // per run
+        };
+
+        bool isFloat(DataType dtype)
+        {
+            return dtype == DataType::Float32 || dtype == DataType::Double ||
+                   dtype == DataType::Float16 || dtype == DataType::BFloat16;
+        }
+
+        void fillInputs(const Operator &op)
+        {
+            uint64_t seed = 0;
+            for (const auto &input : op->getInputs())
+            {
+                // Generators only fill row-major data; a layout copy does not
+                // depend on the values anyway.
+                if (input->isConstant() || input->isBlocked())
+                    continue;
+                // Integers are positive so that Div is defined.
+                if (isFloat(input->getDType()))
+                    input->setData(UniformGenerator(-1, 1, seed++));
+                else
+                    input->setData(IntRangeGenerator(1, 100, seed++));
+            }
+        }
+
+        // The allocator reports the arena on stdout, which would break up
+        // the table.
+        void quietDataMalloc(GraphObj &g)
+        {
+            std::cout.flush();
+            fflush(stdout);
+            int saved = dup(STDOUT_FILENO);
+            int null = open("/dev/null", O_WRONLY);
+            dup2(null, STDOUT_FILENO);
+            close(null);
+            auto restore = [&]
+            {
+                std::cout.flush();
+                fflush(stdout);
+                dup2(saved, STDOUT_FILENO);
+                close(saved);
+            };
+            try
+            {
+                g.dataMalloc();
+            }
+            catch (...)
+            {
+                restore();
+                throw;
+            }
+            restore();
+        }
+
+        Result measure(const Runtime &runtime, const ExecutionPlan &plan,
+                       double minTime)
+        {
+            using Clock = std::chrono::steady_clock;
+            // Warms up the caches and faults in the pages of the arena.
+            runtime->run(plan);
+            vector<double> times;
+            double total = 0;
+            while (times.size() < MinIterations || total < minTime)
+            {
+                auto start = Clock::now();
+                runtime->run(plan);
+                std::chrono::duration<double> time = Clock::now() - start;
+                times.push_back(time.count());
+                total += time.count();
+            }
+            std::sort(times.begin(), times.end());
+            return {"", times.size(), times[times.size() / 2], times[0], 0, 0};
+        }
+
+        string escape(const string &s)
+        {
+            string ret;
+            for (char c : s)
+            {
+                if (c == '"' || c == '\\')
+                    ret += '\\';
+                ret += c;
+            }
+            return ret;
+        }
+
+        // Writes a report in the layout of Google Benchmark's JSON output.
+        void writeJson(const string &path, const Options &options,
+                       const vector<Result> &results)
+        {
+            std::ofstream ofs(path);
+            IT_ASSERT(ofs.is_open(), "Cannot open " + path);
+            char date[64], host[256] = "";
+            auto now = std::time(nullptr);
+            std::strftime(date, sizeof(date), "%FT%T%z", std::localtime(&now));
+            gethostname(host, sizeof(host) - 1);
+            int threads = 1;
+#ifdef _OPENMP
+            threads = omp_get_max_threads();
+#endif
+            ofs << "{\n  \"context\": {\n"
+                << "    \"date\": \"" << date << "\",\n"
+                << "    \"host_name\": \"" << escape(host) << "\",\n"
+                << "    \"num_cpus\": " << std::thread::hardware_concurrency()
+                << ",\n    \"num_threads\": " << threads << ",\n"
+                << "    \"min_time\": " << options.minTime << "\n  },\n"
+                << "  \"benchmarks\": [";
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                const auto &r = results[i];
+                ofs << (i ? "," : "") << "\n    {\n"
+                    << "      \"name\": \"" << escape(r.name) << "\",\n"
+                    << "      \"iterations\": " << r.iterations << ",\n"
+                    << "      \"real_time\": " << r.medianTime * 1e9 << ",\n"
+                    << "      \"min_time\": " << r.minTime * 1e9 << ",\n"
+                    << "      \"time_unit\": \"ns\",\n"
+                    << "      \"bytes_per_second\": "
+                    << r.bytes / r.medianTime << ",\n"
+                    << "      \"flops_per_second\": "
+                    << r.flops / r.medianTime << "\n    }";
+            }
+            ofs << "\n  ]\n}\n";
+            IT_ASSERT(ofs.good(), "Failed to write " + path);
+        }
+
+        bool parse(int argc, char **argv, Options &options)
+        {
+            for (int i = 1; i < argc; ++i)
+            {
+                string arg = argv[i];
+                auto value = [&](const char *flag)
+                {
+                    size_t n = std::strlen(flag);
+                    return arg.compare(0, n, flag) == 0 ? arg.c_str() + n
+                                                        : nullptr;
+                };
+                if (auto v = value("--benchmark_filter="))
+                    options.filter = std::regex(v);
+                else if (auto v = value("--benchmark_min_time="))
+                    options.minTime = std::atof(v);
+                else if (auto v = value("--benchmark_out="))
+                    options.out = v;
+                else if (arg == "--benchmark_list_tests")
+                    options.list = true;
+                else
+                {
+                    fprintf(stderr,
+                            "Usage: %s [--benchmark_filter=REGEX] "
+                            "[--benchmark_min_time=SECONDS] "
+                            "[--benchmark_out=FILE.json] "
+                            "[--benchmark_list_tests]\n",
+                            argv[0]);
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        int run(const Options &options)
+        {
+            Runtime runtime = NativeCpuRuntimeObj::getInstance();
+            const auto &registry = KernelRegistry::getInstance();
+            vector<Result> results;
+            if (!options.list)
+                printf("%-64s %12s %10s %9s %9s\n", "Benchmark", "Time(us)",
+                       "Iterations", "GB/s", "GFLOP/s");
+            for (const auto &benchmark : getBenchmarks())
+            {
+                Graph g = make_ref<GraphObj>(runtime);
+                auto op = benchmark.build(*g);
+                KernelAttrs attrs{Device::CPU, op->getOpType().underlying()};
+                const auto &kernels = registry.getKernelItems(attrs);
+                vector<string> names;
+                for (const auto &kernel : kernels)
+                {
+                    auto name = benchmark.name + "/" + std::get<1>(kernel);
+                    if (std::regex_search(name, options.filter))
+                        names.push_back(std::get<1>(kernel));
+                }
+                if (names.empty())
+                    continue;
+                if (options.list)
+                {
+                    for (const auto &name : names)
+                        printf("%s/%s\n", benchmark.name.c_str(),
+                               name.c_str());
+                    continue;
+                }
+
+                quietDataMalloc(*g);
+                fillInputs(op);
+                double bytes = op->getBytesRead() + op->getBytesWritten();
+                double flops = op->getFlops();
+                for (const auto &name : names)
+                {
+                    auto fullName = benchmark.name + "/" + name;
+                    ExecutionPlan plan;
+                    try
+                    {
+                        Kernel *kernel =
+                            std::get<0>(*registry.getKernelItem(attrs, name));
+                        vector<TensorDesc> descs;
+                        OpRecord record;
+                        lowerOperator(op, kernel, descs, record);
+                        // The kernel does not implement the data type.
+                        if (!kernel->resolve(record))
+                            continue;
+                        plan = g->compile({name});
+                    }
+                    catch (const std::exception &e)
+                    {
+                        fprintf(stderr, "Skipping %s: %s\n", fullName.c_str(),
+                                e.what());
+                        continue;
+                    }
+                    auto result = measure(runtime, plan, options.minTime);
+                    result.name = fullName;
+                    result.bytes = bytes;
+                    result.flops = flops;
+                    printf("%-64s %12.2f %10zu %9.2f %9.2f\n", fullName.c_str(),
+                           result.medianTime * 1e6, result.iterations,
+                           bytes / result.medianTime * 1e-9,
+                           flops / result.medianTime * 1e-9);
+                    fflush(stdout);
+                    results.push_back(std::move(result));
+                }
+            }
+            if (!options.out.empty())
+                writeJson(options.out, options, results);
+            return 0;
+        }
+    } // namespace
+
+} // namespace infini
+
+int main(int argc, char **argv)
+{
+    infini::Options options;
+    if (!infini::parse(argc, argv, options))
+        return 1;
+    return infini::run(options);
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "core/graph.h"
+#include "core/runtime.h"
+#include <functional>
+
+namespace infini
+{
+    /**
+     * @brief A micro-benchmark of one operator. The harness builds a graph
+     * that only holds the operator, fills its inputs with random data and
+     * times every CPU kernel registered for it. Throughput is derived from
+     * OperatorObj::getFlops and the bytes of the inputs and outputs.
+     */
+    struct Benchmark
+    {
+        string name;
+        // Adds the operator and its tensors to an empty graph.
+        std::function<Operator(GraphObj &)> build;
+    };
+
+    vector<Benchmark> &getBenchmarks();
+
+    /**
+     * @brief Registers a benchmark. Returns true so that suites can register
+     * from the initializer of a static variable.
+     */
+    bool addBenchmark(const string &name,
+                      std::function<Operator(GraphObj &)> build);
+
+    // Formats a shape as "2x3x4" for benchmark names.
+    string shapeName(const Shape &shape);
+
+} // namespace infini
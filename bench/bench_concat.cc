@@ -0,0 +1,41 @@
+#include "bench.h"
+#include "operators/concat.h"
+
+namespace infini
+{
+    namespace
+    {
+        const bool registered = []
+        {
+            // Inputs of one shape, joined along the outermost or the
+            // innermost axis.
+            const std::tuple<int, Shape, int> cases[] = {
+                {2, {1024, 1024}, 0},
+                {2, {1024, 1024}, 1},
+                {4, {256, 1024}, 0},
+                {4, {1024, 256}, 1},
+                {8, {8, 64, 56, 56}, 1},
+            };
+            for (const auto &[count, shape, dim] : cases)
+                for (const auto &[dtypeName, dtype] :
+                     {std::pair{"f32", DataType::Float32},
+                      std::pair{"u32", DataType::UInt32}})
+                    addBenchmark("Concat/" + string(dtypeName) + "/" +
+                                     std::to_string(count) + "x" +
+                                     shapeName(shape) + "/axis" +
+                                     std::to_string(dim),
+                                 [=, count = count, shape = shape, dim = dim,
+                                  dtype = dtype](GraphObj &g) -> Operator
+                                 {
+                                     TensorVec inputs;
+                                     for (int i = 0; i < count; ++i)
+                                         inputs.push_back(
+                                             g.addTensor(shape, dtype));
+                                     return g.addOp<ConcatObj>(inputs, nullptr,
+                                                               dim);
+                                 });
+            return true;
+        }();
+    } // namespace
+
+} // namespace infini
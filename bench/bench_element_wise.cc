@@ -0,0 +1,55 @@
+#include "bench.h"
+#include "operators/element_wise.h"
+
+namespace infini
+{
+    namespace
+    {
+        struct Pattern
+        {
+            const char *name;
+            Shape a, b;
+        };
+
+        template <typename T>
+        void addBinary(const string &opName, const Pattern &p,
+                       const string &dtypeName, DataType dtype)
+        {
+            addBenchmark(opName + "/" + p.name + "/" + dtypeName + "/" +
+                             shapeName(p.a) + "+" + shapeName(p.b),
+                         [=](GraphObj &g) -> Operator
+                         {
+                             auto a = g.addTensor(p.a, dtype);
+                             auto b = g.addTensor(p.b, dtype);
+                             return g.addOp<T>(a, b, nullptr);
+                         });
+        }
+
+        const bool registered = []
+        {
+            // Same shapes, then the broadcasts of a scalar, a row, a column,
+            // a channel and the outer sum of a column and a row.
+            const Pattern patterns[] = {
+                {"same", {1024, 1024}, {1024, 1024}},
+                {"same", {16, 64, 32, 32}, {16, 64, 32, 32}},
+                {"scalar", {1024, 1024}, {1}},
+                {"row", {1024, 1024}, {1024}},
+                {"column", {1024, 1024}, {1024, 1}},
+                {"channel", {16, 64, 32, 32}, {1, 64, 1, 1}},
+                {"outer", {1024, 1}, {1, 1024}},
+            };
+            for (const auto &p : patterns)
+                for (const auto &[dtypeName, dtype] :
+                     {std::pair{"f32", DataType::Float32},
+                      std::pair{"u32", DataType::UInt32}})
+                {
+                    addBinary<AddObj>("Add", p, dtypeName, dtype);
+                    addBinary<SubObj>("Sub", p, dtypeName, dtype);
+                    addBinary<MulObj>("Mul", p, dtypeName, dtype);
+                    addBinary<DivObj>("Div", p, dtypeName, dtype);
+                }
+            return true;
+        }();
+    } // namespace
+
+} // namespace infini
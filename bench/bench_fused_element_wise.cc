@@ -0,0 +1,41 @@
+#include "bench.h"
+#include "operators/element_wise.h"
+#include "operators/unary.h"
+
+namespace infini
+{
+    namespace
+    {
+        const bool registered = []
+        {
+            // Relu(a * b + c), fused by the graph pass, with c of the same
+            // shape or a row broadcast like the bias of a linear layer.
+            const std::pair<Shape, Shape> cases[] = {
+                {{1024, 1024}, {1024, 1024}},
+                {{1024, 1024}, {1024}},
+                {{16, 64, 32, 32}, {1, 64, 1, 1}},
+            };
+            for (const auto &[shape, bias] : cases)
+                for (const auto &[dtypeName, dtype] :
+                     {std::pair{"f32", DataType::Float32},
+                      std::pair{"u32", DataType::UInt32}})
+                    addBenchmark(
+                        "FusedElementWise/" + string(dtypeName) + "/" +
+                            shapeName(shape) + "+" + shapeName(bias),
+                        [=, dtype = dtype](GraphObj &g) -> Operator
+                        {
+                            auto a = g.addTensor(shape, dtype);
+                            auto b = g.addTensor(shape, dtype);
+                            auto c = g.addTensor(bias, dtype);
+                            auto mul = g.addOp<MulObj>(a, b, nullptr);
+                            auto add =
+                                g.addOp<AddObj>(mul->getOutput(), c, nullptr);
+                            g.addOp<ReluObj>(add->getOutput(), nullptr);
+                            IT_ASSERT(g.fuseElementWise());
+                            return g.getOperators().front();
+                        });
+            return true;
+        }();
+    } // namespace
+
+} // namespace infini
@@ -0,0 +1,45 @@
+#include "bench.h"
+#include "operators/matmul.h"
+
+namespace infini
+{
+    namespace
+    {
+        struct Case
+        {
+            Shape a, b;
+            bool transB;
+        };
+
+        const bool registered = []
+        {
+            // Square GEMMs, a GEMV, a skinny batch of rows, a transposed B
+            // and a batched product as in attention.
+            const Case cases[] = {
+                {{128, 128}, {128, 128}, false},
+                {{256, 256}, {256, 256}, false},
+                {{512, 512}, {512, 512}, false},
+                {{1, 4096}, {4096, 1024}, false},
+                {{64, 1024}, {1024, 1024}, false},
+                {{256, 512}, {1024, 512}, true},
+                {{8, 128, 64}, {8, 64, 128}, false},
+            };
+            for (const auto &c : cases)
+                for (const auto &[dtypeName, dtype] :
+                     {std::pair{"f32", DataType::Float32},
+                      std::pair{"u32", DataType::UInt32}})
+                    addBenchmark("MatMul/" + string(dtypeName) + "/" +
+                                     shapeName(c.a) + "*" + shapeName(c.b) +
+                                     (c.transB ? "T" : ""),
+                                 [=, dtype = dtype](GraphObj &g) -> Operator
+                                 {
+                                     auto a = g.addTensor(c.a, dtype);
+                                     auto b = g.addTensor(c.b, dtype);
+                                     return g.addOp<MatmulObj>(
+                                         a, b, nullptr, false, c.transB);
+                                 });
+            return true;
+        }();
+    } // namespace
+
+} // namespace infini
@@ -0,0 +1,38 @@
+#include "bench.h"
+#include "operators/reorder.h"
+
+namespace infini
+{
+    namespace
+    {
+        const bool registered = []
+        {
+            // Packing matmul operands into the blocked layout and back,
+            // including a width that leaves a padded last block.
+            const Shape shapes[] = {{1024, 1024}, {768, 1000}};
+            for (const auto &shape : shapes)
+                for (int block : {8, 16})
+                {
+                    const string suffix = "/f32/" + shapeName(shape) +
+                                          "/block" + std::to_string(block);
+                    addBenchmark("Reorder/pack" + suffix,
+                                 [=](GraphObj &g) -> Operator
+                                 {
+                                     auto input = g.addTensor(shape);
+                                     return g.addOp<ReorderObj>(input, nullptr,
+                                                                block);
+                                 });
+                    addBenchmark("Reorder/unpack" + suffix,
+                                 [=](GraphObj &g) -> Operator
+                                 {
+                                     auto input = g.addTensor(shape);
+                                     input->setBlock(block);
+                                     return g.addOp<ReorderObj>(input, nullptr,
+                                                                0);
+                                 });
+                }
+            return true;
+        }();
+    } // namespace
+
+} // namespace infini
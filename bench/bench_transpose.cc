@@ -0,0 +1,36 @@
+#include "bench.h"
+#include "operators/transpose.h"
+
+namespace infini
+{
+    namespace
+    {
+        const bool registered = []
+        {
+            // Matrix transposes, NCHW <-> NHWC and swapping the sequence and
+            // head axes of attention.
+            const std::pair<Shape, vector<int>> cases[] = {
+                {{1024, 1024}, {1, 0}},
+                {{4096, 256}, {1, 0}},
+                {{8, 64, 56, 56}, {0, 2, 3, 1}},
+                {{8, 56, 56, 64}, {0, 3, 1, 2}},
+                {{8, 128, 12, 64}, {0, 2, 1, 3}},
+            };
+            for (const auto &[shape, permute] : cases)
+                for (const auto &[dtypeName, dtype] :
+                     {std::pair{"f32", DataType::Float32},
+                      std::pair{"u32", DataType::UInt32}})
+                    addBenchmark("Transpose/" + string(dtypeName) + "/" +
+                                     shapeName(shape) + "/perm" +
+                                     shapeName(permute),
+                                 [=, dtype = dtype](GraphObj &g) -> Operator
+                                 {
+                                     auto input = g.addTensor(shape, dtype);
+                                     return g.addOp<TransposeObj>(
+                                         input, nullptr, permute);
+                                 });
+            return true;
+        }();
+    } // namespace
+
+} // namespace infini
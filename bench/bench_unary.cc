@@ -0,0 +1,59 @@
+#include "bench.h"
+#include "operators/unary.h"
+
+namespace infini
+{
+    namespace
+    {
+        const bool registered = []
+        {
+            const Shape shapes[] = {{1 << 20}, {16, 64, 56, 56}};
+            for (const auto &shape : shapes)
+            {
+                for (const auto &[dtypeName, dtype] :
+                     {std::pair{"f32", DataType::Float32},
+                      std::pair{"u32", DataType::UInt32}})
+                    addBenchmark("Relu/" + string(dtypeName) + "/" +
+                                     shapeName(shape),
+                                 [=, dtype = dtype](GraphObj &g) -> Operator
+                                 {
+                                     auto input = g.addTensor(shape, dtype);
+                                     return g.addOp<ReluObj>(input, nullptr);
+                                 });
+                addBenchmark("Clip/f32/" + shapeName(shape),
+                             [=](GraphObj &g) -> Operator
+                             {
+                                 auto input = g.addTensor(shape);
+                                 return g.addOp<ClipObj>(input, nullptr,
+                                                         -0.5f, 0.5f);
+                             });
+            }
+
+            // Conversions between the floating point formats and to and
+            // from integers.
+            const std::tuple<const char *, CastType, DataType> casts[] = {
+                {"f32_f16", CastType::Float2Float16, DataType::Float32},
+                {"f16_f32", CastType::Float162Float, DataType::Float16},
+                {"f32_bf16", CastType::Float2BFloat16, DataType::Float32},
+                {"bf16_f32", CastType::BFloat162Float, DataType::BFloat16},
+                {"f32_i32", CastType::Float2Int32, DataType::Float32},
+                {"i32_f32", CastType::Int322Float, DataType::Int32},
+                {"i32_i64", CastType::Int322Int64, DataType::Int32},
+                {"i8_f32", CastType::Int82Float, DataType::Int8},
+            };
+            for (const auto &shape : shapes)
+                for (const auto &[castName, type, dtype] : casts)
+                    addBenchmark("Cast/" + string(castName) + "/" +
+                                     shapeName(shape),
+                                 [=, type = type, dtype = dtype](
+                                     GraphObj &g) -> Operator
+                                 {
+                                     auto input = g.addTensor(shape, dtype);
+                                     return g.addOp<CastObj>(input, nullptr,
+                                                             type);
+                                 });
+            return true;
+        }();
+    } // namespace
+
+} // namespace infini
@@ -27,7 +27,12 @@ namespace infini {
     // TODO：可能需要设计一个数据结构来存储free block，以便于管理和合并
     // HINT: 可以使用一个 map 来存储 free block，key 为 block 的起始/结尾地址，value 为 block 的大小
     // =================================== 作业 ===================================
-    std::map<size_t,size_t> freeBlocks{{0,1024*1024}};
+    // Free blocks below `top`, keyed by offset. Memory above `top` is free
+    // and unbounded, so the arena grows as needed.
+    std::map<size_t,size_t> freeBlocks;
+
+    // end offset of the highest allocated block
+    size_t top;
   public:
     Allocator(Runtime runtime);
 
@@ -49,8 +54,15 @@ namespace infini {
     // return: pointer to the head address of the allocated memory
     void *getPtr();
 
+    // function: release the actual memory and forget all allocations, so that
+    // the allocator can plan again
+    void reset();
+
     void info();
 
+    // function: size of the arena needed by the allocations so far
+    size_t getPeak() const { return peak; }
+
   private:
     // function: memory alignment, rouned up
     // return: size of the aligned memory block
@@ -0,0 +1,56 @@
+#pragma once
+#include "core/kernel.h"
+
+namespace infini
+{
+    /**
+     * @brief Chooses among the candidate kernels registered for an op type.
+     * The first time a workload is seen, every candidate is timed on the
+     * actual tensors of the op and the fastest one is remembered per workload,
+     * i.e. op type, data type, input shapes and attributes. Decisions can be
+     * persisted to a text file so later processes skip tuning.
+     */
+    class Autotuner
+    {
+        bool enabled = false;
+        int warmup = 1, repeat = 3;
+        string cachePath;
+        std::map<string, string> cache; // workload key -> kernel name
+
+    public:
+        static Autotuner &getInstance()
+        {
+            static Autotuner instance;
+            return instance;
+        }
+
+        void enable() { enabled = true; }
+        void disable() { enabled = false; }
+        bool isEnabled() const { return enabled; }
+        void setRepeat(int warmupRuns, int timedRuns)
+        {
+            warmup = warmupRuns;
+            repeat = timedRuns;
+        }
+
+        /**
+         * @brief Loads decisions from `path` if it exists. New decisions are
+         * written back to it as soon as they are made.
+         */
+        void setCacheFile(const string &path);
+        void save() const;
+        void clear() { cache.clear(); }
+        const std::map<string, string> &getCache() const { return cache; }
+
+        /**
+         * @brief Gets the kernel record to use for `op`. Its tensors must have
+         * data, since candidates are benchmarked on them.
+         */
+        const KernelRegistry::KernelRecord &select(const KernelAttrs &attrs,
+                                                   const Operator &op);
+
+        static string workloadKey(const KernelAttrs &attrs,
+                                  const Operator &op);
+    };
+
+} // namespace infini
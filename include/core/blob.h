@@ -11,12 +11,26 @@ class BlobObj
 {
   Runtime runtime;
   void *ptr;
+  bool owned;
+  std::shared_ptr<void> owner;
 
 public:
-  BlobObj(Runtime runtime, void *ptr) : runtime(runtime), ptr(ptr) {}
+  BlobObj(Runtime runtime, void *ptr)
+      : runtime(runtime), ptr(ptr), owned(false) {}
+  /**
+   * @brief Allocates `size` zeroed bytes from `runtime`. The memory is owned
+   * by the blob and released with it.
+   */
+  BlobObj(Runtime runtime, size_t size);
+  /**
+   * @brief Refers to memory kept alive by `owner`, e.g. a mapped file,
+   * which is released when the last blob referring to it is gone.
+   */
+  BlobObj(Runtime runtime, void *ptr, std::shared_ptr<void> owner)
+      : runtime(runtime), ptr(ptr), owned(false), owner(std::move(owner)) {}
   BlobObj(BlobObj &other) = delete;
   BlobObj &operator=(BlobObj const &) = delete;
-  ~BlobObj() {};
+  ~BlobObj();
 
   template <typename T>
   T getPtr() const { return reinterpret_cast<T>(ptr); }
@@ -0,0 +1,110 @@
+#pragma once
+#include "core/graph.h"
+#include "core/plan.h"
+
+namespace infini
+{
+    /**
+     * @brief Serves a graph whose inputs have symbolic dimensions, such as
+     * batch or sequence length. Every symbol gets a sorted list of bucket
+     * sizes, and plan() infers the shapes, lays out memory and compiles an
+     * execution plan for every combination of buckets ahead of time. All
+     * buckets share a single arena sized for the largest one.
+     *
+     * At run time select() routes the actual sizes to the smallest fitting
+     * bucket by rebinding the precomputed shapes and blobs, without shape
+     * inference, memory planning or heap allocation. Inputs are padded up to
+     * the bucket shape, e.g. with copyPadded; padding only gives the same
+     * result on the valid region if it does not flow into a reduction.
+     *
+     * The graph must not be changed after plan().
+     */
+    class BucketPlanner
+    {
+        struct Binding
+        {
+            Tensor tensor;
+            int axis;
+        };
+        struct Symbol
+        {
+            string name;
+            vector<Binding> bindings;
+            vector<int> buckets;
+        };
+        struct Bucket
+        {
+            vector<int> values; // one per symbol
+            vector<Shape> shapes; // one per tensor
+            vector<Blob> blobs; // nullptr for constants
+            ExecutionPlan plan;
+        };
+
+        Graph graph;
+        vector<Symbol> symbols;
+        TensorVec tensors;
+        std::unordered_map<const TensorObj *, size_t> tensorIndex;
+        vector<Bucket> buckets;
+        Blob arena;
+        size_t arenaSize = 0;
+        int current = -1;
+
+        void inferShapes(const vector<int> &values);
+        void bind(const Bucket &bucket);
+
+    public:
+        explicit BucketPlanner(Graph graph) : graph(std::move(graph)) {}
+
+        /**
+         * @brief Declares that dimension `axis` of the graph input `tensor`
+         * is the symbol `name`. A symbol can bind several inputs, which then
+         * always have the same size along their axes.
+         */
+        void addSymbol(const string &name, const Tensor &tensor, int axis);
+
+        /**
+         * @brief Sets the bucket sizes of `name`. By default a symbol only
+         * has the size the bound inputs currently have.
+         */
+        void setBuckets(const string &name, vector<int> sizes);
+
+        /**
+         * @brief Powers of two from `min` to `max`, with `max` appended if
+         * it is not a power of two.
+         */
+        static vector<int> powersOfTwo(int min, int max);
+
+        /**
+         * @brief Plans every combination of buckets and binds the largest.
+         */
+        void plan();
+
+        /**
+         * @brief Binds the smallest bucket that fits `values`, given in the
+         * order symbols were added, and returns its plan.
+         */
+        const ExecutionPlan &select(const vector<int> &values);
+
+        /**
+         * @brief Copies a row-major `shape`-shaped array from `src` into
+         * `tensor` with its currently bound shape, zero-filling the rest.
+         */
+        static void copyPadded(const Tensor &tensor, const void *src,
+                               const Shape &shape);
+
+        /**
+         * @brief Describes each dimension of `tensor` as a number if it is
+         * the same in every bucket, as a symbol or a multiple of one, e.g.
+         * "2*seq", if it follows that symbol, and "?" otherwise.
+         */
+        vector<string> getSymbolicShape(const Tensor &tensor) const;
+
+        size_t getNumBuckets() const { return buckets.size(); }
+        size_t getArenaSize() const { return arenaSize; }
+        /**
+         * @brief Gets the bucket sizes of the bound bucket.
+         */
+        const vector<int> &getBucket() const;
+    };
+
+} // namespace infini
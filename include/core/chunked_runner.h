@@ -0,0 +1,91 @@
+#pragma once
+#include "core/graph.h"
+#include "core/plan.h"
+#include <functional>
+
+namespace infini
+{
+    /**
+     * @brief Runs a graph over inputs whose leading axis is too long to be
+     * held in memory at once, e.g. in offline batch jobs. The leading axis
+     * of every graph input is split into chunks of a fixed number of rows
+     * and each chunk runs through the graph in an arena sized for one
+     * chunk, so peak memory depends on the chunk size, not the input size.
+     * Inputs are pulled from a source and outputs pushed to a sink one
+     * chunk at a time.
+     *
+     * This requires every op to treat rows of the leading axis
+     * independently: element-wise and unary ops whose other inputs do not
+     * span that axis, MatMul along M or leading batch dimensions, Transpose
+     * keeping axis 0 first, Concat along another axis, Cast and Reorder.
+     *
+     * The runner reshapes the graph, which must not be used elsewhere
+     * meanwhile.
+     */
+    class ChunkedRunner
+    {
+    public:
+        /**
+         * @brief Writes rows [row, row + rows) of `input` into `data`, which
+         * is laid out like a dense input of `rows` rows.
+         */
+        using Source = std::function<void(const Tensor &input, size_t row,
+                                          size_t rows, void *data)>;
+        /**
+         * @brief Receives rows [row, row + rows) of `output` in `data`,
+         * which is only valid during the call.
+         */
+        using Sink = std::function<void(const Tensor &output, size_t row,
+                                        size_t rows, const void *data)>;
+
+    private:
+        Graph graph;
+        size_t chunkRows;
+        TensorVec inputs, outputs;
+        ExecutionPlan plan;
+        size_t plannedRows = 0;
+        size_t arenaSize = 0;
+
+        void prepare(size_t rows);
+
+    public:
+        ChunkedRunner(Graph graph, size_t chunkRows);
+
+        /**
+         * @brief Whether all ops of `graph` treat rows of the leading axis of
+         * the graph inputs independently.
+         */
+        static bool isChunkable(const Graph &graph);
+
+        /**
+         * @brief Runs `totalRows` rows through the graph, chunk by chunk. The
+         * last chunk may be shorter, in which case the graph is planned once
+         * more for it.
+         */
+        void run(size_t totalRows, const Source &source, const Sink &sink);
+
+        /**
+         * @brief Non-constant graph inputs and graph outputs, in the order of
+         * GraphObj::getInputs and getOutputs.
+         */
+        const TensorVec &getInputs() const { return inputs; }
+        const TensorVec &getOutputs() const { return outputs; }
+        /**
+         * @brief Bytes of the largest arena planned so far, i.e. the arena
+         * for a full chunk once run() was called.
+         */
+        size_t getArenaSize() const { return arenaSize; }
+
+        /**
+         * @brief A source reading dense inputs from memory, e.g. files mapped
+         * with mapFile, one buffer per element of getInputs().
+         */
+        Source fromBuffers(vector<const void *> buffers) const;
+        /**
+         * @brief A sink concatenating the chunks of every output into dense
+         * buffers, one per element of getOutputs().
+         */
+        Sink toBuffers(vector<void *> buffers) const;
+    };
+
+} // namespace infini
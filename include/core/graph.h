@@ -4,59 +4,274 @@
 #include "core/tensor.h"
 #include <algorithm>
 #include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace infini
 {
+    /**
+     * @brief Offsets of the tensors of a graph in its memory arena, in the
+     * order of GraphObj::getTensors. Offsets of constants, views and
+     * external tensors are unused.
+     */
+    struct MemoryPlan
+    {
+        vector<size_t> offsets;
+        size_t size = 0;
+    };
+
 
     class GraphObj : public Object
     {
     protected:
         Runtime runtime;
+        // Operators and tensors in order. Passes only drop removed elements
+        // from the hash indexes below and compact the vectors once at the
+        // end, so that removing many elements costs O(n) in total instead of
+        // O(n) each.
         TensorVec tensors;
         OpVec ops;
+        std::unordered_set<const TensorObj *> tensorIndex;
+        std::unordered_set<const OperatorObj *> opIndex;
+        std::unordered_map<UidBaseType, Tensor> fuidIndex;
+        // Removed elements that are still in the vectors.
+        std::unordered_set<const TensorObj *> removedTensors;
+        std::unordered_set<const OperatorObj *> removedOps;
         Allocator allocator;
+        MemoryPlan memoryPlan;
 
     public:
         explicit GraphObj(Runtime runtime)
-            : runtime(runtime), allocator(runtime), sorted(false){};
+            : runtime(runtime), allocator(runtime), sorted(false),
+              capture(false){};
         string toString() const override;
         Runtime getRuntime() const { return runtime; }
 
         Tensor addTensor(Shape dim, DataType dtype = DataType::Float32);
         Tensor addTensor(const Tensor &tensor);
         TensorVec addTensor(const TensorVec &tensors);
+        /**
+         * @brief Removes `op` from the graph. Its connections are left
+         * untouched.
+         */
         void removeOperator(Operator op)
         {
-            auto it = std::find(ops.begin(), ops.end(), op);
-            if (it != ops.end())
-                ops.erase(it);
+            removeOperatorLazily(op);
+            compact();
         }
 
+        /**
+         * @brief Removes `tensor` from the graph.
+         */
         void removeTensor(Tensor tensor)
         {
-            auto it = std::find(tensors.begin(), tensors.end(), tensor);
-            if (it != tensors.end())
-                tensors.erase(it);
+            removeTensorLazily(tensor);
+            compact();
         }
 
-        const TensorVec &getTensors() const { return tensors; }
-        const OpVec &getOperators() const { return ops; }
-        Tensor getTensor(int) const;
+        bool hasOperator(const Operator &op) const
+        {
+            return opIndex.count(op.get());
+        }
+        bool hasTensor(const Tensor &tensor) const
+        {
+            return tensorIndex.count(tensor.get());
+        }
+
+        const TensorVec &getTensors() const
+        {
+            IT_ASSERT(removedTensors.empty(),
+                      "Removed tensors are pending compaction");
+            return tensors;
+        }
+        const OpVec &getOperators() const
+        {
+            IT_ASSERT(removedOps.empty(),
+                      "Removed operators are pending compaction");
+            return ops;
+        }
+        /**
+         * @brief Gets the tensor with the given fuid, or nullptr.
+         */
+        Tensor getTensor(int fuid) const;
 
         /**
-         * @brief Sort the nodes in topological order.
+         * @brief Sort the nodes in topological order with Kahn's algorithm,
+         * keeping the current relative order of independent nodes.
          * It returns true if the sorting is successful.
          * Otherwise false is returned, means that there are rings in the graph,
          * so the topological sorting fails.
          */
         bool topo_sort();
 
+        /**
+         * @brief Declares that the operators are already in topological
+         * order, e.g. because a loader added them in that order, so that
+         * topo_sort has nothing to do.
+         */
+        void markSorted();
+
+        /**
+         * @brief Runs the default PassManager pipeline to a fixpoint:
+         * constant folding, common subexpression elimination, transpose
+         * canonicalization, MatMul epilogue folding and element-wise fusion.
+         * Use a PassManager directly to pick passes or read statistics.
+         */
         void optimize();
 
+        /**
+         * @brief Evaluates every operator whose inputs are all constant with
+         * the CPU kernels and replaces it with its outputs, which become
+         * constants. Constants that are no longer read are removed. Returns
+         * whether the graph changed.
+         */
+        bool foldConstants();
+
+        /**
+         * @brief Merges operators with the same type and attributes that read
+         * the same input tensors. Consumers of a duplicate are redirected to
+         * the first such operator in topological order and the duplicate is
+         * removed with its outputs. Returns whether the graph changed.
+         */
+        bool eliminateCommonSubexpressions();
+
+        /**
+         * @brief Composes chains of Transposes into one permutation, removes
+         * identity Transposes, sinks Transposes below layout-agnostic ops
+         * (unary, Clip, Cast and same-shape element-wise) when that lets them
+         * meet and compose, and folds swaps of the last two axes into MatMul.
+         * Returns whether the graph changed.
+         */
+        bool canonicalizeTranspose();
+
+        /**
+         * @brief Folds a bias Add and then a Relu or Clip that consume the
+         * output of a MatMul, and nothing else does, into the epilogue of the
+         * MatMul. Returns whether the graph changed.
+         */
+        bool fuseMatmulEpilogue();
+
+        /**
+         * @brief Replaces every maximal tree of element-wise and unary
+         * operators (Add, Sub, Mul, Div, Relu, Clip and identity Cast) with a
+         * single FusedElementWiseObj. A producer joins its consumer's tree
+         * when its output has the same shape and data type as the tree's
+         * output and no other consumer, so the intermediate tensor can be
+         * dropped from the graph. Returns whether the graph changed.
+         */
+        bool fuseElementWise();
+
+        /**
+         * @brief Gives the B operands of MatMuls a blocked layout with
+         * `block` columns per panel, see TensorObj::getBlock. `block` is 8
+         * or 16, the widths the packed kernel supports; 0 picks the SIMD
+         * width of the host. Constants are packed once by the pass,
+         * transposing them if the MatMul did. Other operands are packed by
+         * a Reorder, one per tensor however many MatMuls read it, and only
+         * if the MatMul has at least `block` rows to reuse each panel.
+         * Everything else stays plain, so no other reorders are needed.
+         * Not part of the default pipeline. Returns whether the graph
+         * changed.
+         */
+        bool chooseLayouts(int block = 0);
+
+        /**
+         * @brief Sets the shape of `tensor`, usually a graph input, and marks
+         * its consumers for the next shape_infer. Nothing is re-inferred
+         * yet, so several inputs can be reshaped consistently first.
+         */
+        void setShape(const Tensor &tensor, const Shape &shape);
+
+        /**
+         * @brief Re-infers output shapes. If shapes were changed through
+         * setShape, only operators downstream of them are visited, in
+         * topological order, and propagation stops at outputs whose shape is
+         * unchanged. Otherwise every operator is visited, which also picks up
+         * shapes changed directly on tensors, including graph inputs whose
+         * change does not alter any output shape.
+         *
+         * Any shape change drops the captured plan. If the graph has memory
+         * and the byte size of a tensor changed, memory is planned again with
+         * dataMalloc, so the data of all tensors has to be set again.
+         */
         void shape_infer();
 
+        /**
+         * @brief Plans the memory of all non-constant tensors in one arena.
+         * Can be called again, e.g. after shapes changed; previous data is
+         * lost.
+         *
+         * The output of a view op such as Transpose gets no memory of its
+         * own if it is not a graph output and the kernels of all its
+         * consumers read strided inputs. It becomes a strided view of the
+         * input and the op does nothing when run. Otherwise the op runs and
+         * materializes a dense copy.
+         */
         void dataMalloc();
 
+        /**
+         * @brief Binds the tensors to a new arena laid out by `plan`, e.g. a
+         * plan saved from an identical graph, without planning again.
+         */
+        void dataMalloc(const MemoryPlan &plan);
+
+        /**
+         * @brief Binds caller-owned memory, such as a network receive buffer
+         * or a numpy array, as the data of `tensor`, a non-constant graph
+         * input or output, so that no copy in or out is needed. `data` must
+         * hold getBytes() bytes and stay valid while the graph runs with
+         * it. Binding again before every run is cheap, and the captured plan
+         * follows the new address. A plan returned by compile() does not:
+         * it keeps reading the old buffer until its owner calls
+         * ExecutionPlanObj::updateExternals.
+         *
+         * External tensors are left out of the arena. The first binding of
+         * a tensor plans the arena again if one was allocated, which loses
+         * the data of the other tensors and invalidates compiled plans, so
+         * bind before setting inputs and compiling.
+         */
+        void bindExternal(const Tensor &tensor, void *data);
+        /**
+         * @brief Returns `tensor` to the arena, planning it again if one was
+         * allocated.
+         */
+        void unbindExternal(const Tensor &tensor);
+
+        /**
+         * @brief The layout chosen by the last dataMalloc.
+         */
+        const MemoryPlan &getMemoryPlan() const { return memoryPlan; }
+
+        /**
+         * @brief Lowers the graph into an immutable execution plan. Must be
+         * called after dataMalloc; the plan is invalidated by any later change
+         * to the graph, its shapes or its data blobs.
+         */
+        ExecutionPlan compile();
+        /**
+         * @brief Compiles with the kernel named in `kernels` for every
+         * operator, in topological order.
+         */
+        ExecutionPlan compile(const vector<string> &kernels);
+
+        /**
+         * @brief In capture mode the first run lowers the graph into an
+         * execution plan and later runs replay it. The captured plan is dropped
+         * whenever operators, shapes or memory of the graph change.
+         */
+        void setCaptureMode(bool enable)
+        {
+            capture = enable;
+            invalidatePlan();
+        }
+        bool isCaptureEnabled() const { return capture; }
+
+        /**
+         * @brief Gets the captured plan, compiling it if there is none.
+         */
+        ExecutionPlan getCapturedPlan();
+        void invalidatePlan() { capturedPlan = nullptr; }
+
         /**
          * @brief Add an operator and create its outputs. Output tensor arguments
          * should be empty Refs (e.g., nullptr).
@@ -86,7 +301,7 @@ namespace infini
         inline TensorVec getInputs() const
         {
             TensorVec ret;
-            for (const auto &t : tensors)
+            for (const auto &t : getTensors())
                 if (!t->getSource())
                     ret.emplace_back(t);
             return ret;
@@ -98,24 +313,150 @@ namespace infini
         inline TensorVec getOutputs() const
         {
             TensorVec ret;
-            for (const auto &t : tensors)
-                if (t->getTargets().empty())
+            for (const auto &t : getTensors())
+                if (t->getNumTargets() == 0)
                     ret.emplace_back(t);
             return ret;
         }
 
         bool checkValid() const;
 
+        /**
+         * @brief Sum of the estimated FLOPs of all operators.
+         */
+        int64_t getFlops() const;
+        /**
+         * @brief Sum of the bytes read and written by all operators.
+         * Intermediate tensors count once as written and once per read.
+         */
+        int64_t getBytesMoved() const;
+
+        /**
+         * @brief A roofline table for a machine with the given peak compute
+         * and memory bandwidth. Each operator gets its FLOPs, bytes,
+         * arithmetic intensity, whether it is compute or memory bound,
+         * attainable GFLOP/s and the lower bound of its run time, followed
+         * by the totals.
+         */
+        string rooflineReport(double peakGflops, double peakGBps) const;
+
     private:
+        /**
+         * @brief Remove `op` or `tensor` in O(1), leaving it in the vectors
+         * until compact(). Passes use them for batch mutation and compact
+         * before they return.
+         */
+        void removeOperatorLazily(const Operator &op)
+        {
+            invalidatePlan();
+            if (opIndex.erase(op.get()))
+                removedOps.insert(op.get());
+        }
+        void removeTensorLazily(const Tensor &tensor)
+        {
+            invalidatePlan();
+            if (tensorIndex.erase(tensor.get()))
+            {
+                fuidIndex.erase(tensor->getFuid());
+                removedTensors.insert(tensor.get());
+            }
+        }
+
+        /**
+         * @brief Drops lazily removed elements from the vectors returned by
+         * getTensors and getOperators.
+         */
+        void compact();
+
         /**
          * @brief Add reverse connections and Op relationship in ctor.
          */
         void addOperatorAndConnect(const Operator &op);
 
+        /**
+         * @brief Removes `op` and every connection to it. Its tensors stay in
+         * the graph.
+         */
+        void detachOperator(const Operator &op);
+
+        /**
+         * @brief `op` takes over the output of `consumer`, its only consumer,
+         * and `consumer` is removed along with the tensor between them. Other
+         * inputs of `consumer` are not moved to `op`.
+         */
+        void absorbConsumer(const Operator &op, const Operator &consumer);
+
+        /**
+         * @brief Appends `tensor` to the inputs of `op` and connects them.
+         */
+        void connectInput(const Operator &op, const Tensor &tensor);
+
+        /**
+         * @brief Makes `op` read `to` wherever it read `from`.
+         */
+        void redirectInput(const Operator &op, const Tensor &from,
+                           const Tensor &to);
+
+        /**
+         * @brief Makes every consumer of `from` read `to` instead.
+         */
+        void replaceAllUses(const Tensor &from, const Tensor &to);
+
+        /**
+         * @brief If `tensor` has no consumer, removes its producer and the
+         * producer's outputs, then repeats for the producer's inputs. Graph
+         * inputs are kept. The inputs of removed producers are appended to
+         * `touched` when given.
+         */
+        void removeDeadCone(const Tensor &tensor, TensorVec *touched = nullptr);
+
+        // Single rewrite steps of canonicalizeTranspose. They return whether
+        // the graph changed, and append the tensors whose producer or
+        // consumers changed to `touched`.
+        bool rewriteTranspose(const Operator &op, TensorVec &touched);
+        bool sinkTranspose(const Operator &op, TensorVec &touched);
+
+        /**
+         * @brief Re-infers the outputs of `op`. Returns whether a shape
+         * changed; `resized` is set if a byte size changed or a view was
+         * reshaped, both of which need a new dataMalloc.
+         */
+        bool inferOutputShapes(const Operator &op, bool &resized);
+
+        /**
+         * @brief Chooses the view ops whose outputs are bound as views by
+         * dataMalloc, in topological order, and adds their outputs to
+         * `outputs`.
+         */
+        OpVec planViews(std::unordered_set<const TensorObj *> &outputs);
+        /**
+         * @brief Binds the outputs of `views` once their inputs have data.
+         */
+        void bindViews(const OpVec &views) const;
+        /**
+         * @brief Remembers the shape and size of every graph input, so that
+         * shape_infer notices inputs reshaped on the tensor itself.
+         */
+        void recordInputShapes();
+
         /**
          * @brief If the nodes is sorted in topological order.
          */
         bool sorted;
+        // Position of every operator in the last topological order.
+        std::unordered_map<const OperatorObj *, size_t> opOrder;
+        // Consumers of tensors reshaped by setShape since the last
+        // shape_infer.
+        OpVec dirtyOps;
+        bool resizedInputs = false;
+        // Shapes and byte sizes of the graph inputs at the last shape_infer
+        // or dataMalloc, to notice inputs reshaped directly on the tensor.
+        std::unordered_map<const TensorObj *, std::pair<Shape, size_t>>
+            inputShapes;
+        bool allocated = false;
+
+        bool capture;
+        ExecutionPlan capturedPlan;
     };
 
 } // namespace infini
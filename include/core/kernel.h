@@ -1,5 +1,6 @@
 #pragma once
 #include "core/common.h"
+#include "core/op_record.h"
 #include "core/operator.h"
 #include "core/tensor.h"
 #include "utils/operator_utils.h"
@@ -21,8 +22,54 @@ namespace infini
          */
         virtual void compute(const Operator &op,
                              const RuntimeObj *context) const = 0;
+
+        /**
+         * @brief Executes a lowered operator record. Kernels reached through an
+         * execution plan must not allocate or touch the graph here.
+         */
+        virtual void execute(const OpRecord &record,
+                             const RuntimeObj *context) const
+        {
+            KernelFunc func = resolve(record);
+            IT_ASSERT(func != nullptr, "Kernel does not support data type " +
+                                           record.dtype.toString());
+            func(record, context);
+        }
+
+        /**
+         * @brief Selects the entry point for the op type and data type of the
+         * record. Execution plans call it once and then invoke the returned
+         * function directly. Returns nullptr for a data type the kernel does
+         * not implement.
+         */
+        virtual KernelFunc resolve(const OpRecord &record) const = 0;
+
+        /**
+         * @brief Fills the kernel-specific part of a record, i.e. the operator
+         * attributes in `record.attrs`. Tensors are already resolved.
+         */
+        virtual void lower(const Operator &op, OpRecord &record) const {}
+
+        /**
+         * @brief Whether the kernel reads inputs through the strides of their
+         * descriptors, so that inputs can be views such as the output of an
+         * elided Transpose. Outputs are always dense.
+         */
+        virtual bool supportsStridedInputs() const { return false; }
+
+        /**
+         * @brief Whether the kernel handles tensors with a blocked layout,
+         * see TensorObj::getBlock. Lowering rejects blocked tensors for
+         * other kernels.
+         */
+        virtual bool supportsBlockedLayouts() const { return false; }
     };
 
+    /**
+     * @brief Maps a (device, op type) key to its candidate kernels. The first
+     * kernel registered for a key is the default one; further candidates are
+     * only chosen by the autotuner.
+     */
     class KernelRegistry
     {
     public:
@@ -30,14 +77,15 @@ namespace infini
             tuple<Kernel *const, const string, const int>; // Kernel, name, ID
 
     private:
-        std::map<KernelAttrs, KernelRecord> kernels;
+        std::map<KernelAttrs, vector<KernelRecord>> kernels;
         int nKernels = 0;
 
     public:
         ~KernelRegistry()
         {
             for (auto &[k, v] : kernels)
-                delete std::get<0>(v);
+                for (auto &record : v)
+                    delete std::get<0>(record);
         }
         static KernelRegistry &getInstance()
         {
@@ -46,30 +94,72 @@ namespace infini
         }
         bool registerKernel(const KernelAttrs &key, Kernel *kernel, string name)
         {
-            IT_ASSERT(kernels.find(key) == kernels.end(),
-                      "Kernel already registered");
-            kernels.emplace(key, KernelRecord{kernel, name, ++nKernels});
+            auto &candidates = kernels[key];
+            for (const auto &record : candidates)
+                IT_ASSERT(std::get<1>(record) != name,
+                          "Kernel " + name + " already registered");
+            candidates.emplace_back(kernel, name, ++nKernels);
             return true;
         }
+        bool hasKernel(const KernelAttrs &kernelAttrs) const
+        {
+            return kernels.count(kernelAttrs) > 0;
+        }
         Kernel *getKernel(const KernelAttrs &kernelAttrs) const
+        {
+            return std::get<0>(getKernelItem(kernelAttrs));
+        }
+        const KernelRecord &getKernelItem(const KernelAttrs &kernelAttrs) const
+        {
+            return getKernelItems(kernelAttrs).front();
+        }
+        /**
+         * @brief Gets all candidates for a key in registration order.
+         */
+        const vector<KernelRecord> &
+        getKernelItems(const KernelAttrs &kernelAttrs) const
         {
             auto it = kernels.find(kernelAttrs);
             IT_ASSERT(it != kernels.end(), "Kernel not found for key {" +
                                                get_kernel_attrs_str(kernelAttrs) +
                                                "}");
-            return std::get<0>(it->second);
+            return it->second;
         }
-        const KernelRecord &getKernelItem(const KernelAttrs &kernelAttrs) const
+        /**
+         * @brief Whether every candidate for a key reads strided inputs, so
+         * that any choice of the autotuner can.
+         */
+        bool supportsStridedInputs(const KernelAttrs &kernelAttrs) const
         {
-            return kernels.at(kernelAttrs);
+            auto it = kernels.find(kernelAttrs);
+            if (it == kernels.end())
+                return false;
+            for (const auto &record : it->second)
+                if (!std::get<0>(record)->supportsStridedInputs())
+                    return false;
+            return true;
+        }
+        /**
+         * @brief Gets the candidate with the given name, or nullptr.
+         */
+        const KernelRecord *getKernelItem(const KernelAttrs &kernelAttrs,
+                                          const string &name) const
+        {
+            for (const auto &record : getKernelItems(kernelAttrs))
+                if (std::get<1>(record) == name)
+                    return &record;
+            return nullptr;
         }
     };
 
     class CpuKernelWithoutConfig : public Kernel
     {
     public:
-        virtual void compute(const Operator &op,
-                             const RuntimeObj *context) const = 0;
+        /**
+         * @brief Lowers the operator into a temporary record and executes it.
+         */
+        void compute(const Operator &op,
+                     const RuntimeObj *context) const override;
     };
 
 } // namespace infini
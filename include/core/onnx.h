@@ -0,0 +1,31 @@
+#pragma once
+#include "core/graph.h"
+
+namespace infini
+{
+    /**
+     * @brief A graph imported from an ONNX model, with its inputs and outputs
+     * in the order the model declares them.
+     */
+    struct OnnxModel
+    {
+        Graph graph;
+        TensorVec inputs, outputs;
+        std::map<string, Tensor> tensors; // by ONNX value name
+    };
+
+    /**
+     * @brief Imports the ONNX model at `path`. The file is read with a small
+     * protobuf wire-format reader, so libprotobuf is not needed. Supported
+     * nodes are Add, Sub, Mul, Div, Relu, Clip, Cast, MatMul, Gemm,
+     * Transpose, Concat and Constant.
+     *
+     * The file is mapped into memory and initializers stored as raw data
+     * become constants that refer to the mapped bytes in place, unless they
+     * are misaligned for their data type, in which case they are copied.
+     * Symbolic input dimensions take their value from `dimParams`.
+     */
+    OnnxModel importOnnx(Runtime runtime, const string &path,
+                         const std::map<string, int> &dimParams = {});
+
+} // namespace infini
@@ -0,0 +1,122 @@
+#pragma once
+#include "core/data_type.h"
+#include "core/op_type.h"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace infini
+{
+    class Kernel;
+    class OperatorObj;
+    class RuntimeObj;
+    struct OpRecord;
+    struct FusedStep;
+
+    /**
+     * @brief A kernel entry point specialized for one op type and data type.
+     */
+    using KernelFunc = void (*)(const OpRecord &record,
+                                const RuntimeObj *context);
+
+    /**
+     * @brief The highest tensor rank an execution plan can describe. Tensor
+     * descriptors use fixed-size arrays so that plans never allocate while they
+     * are executed.
+     */
+    constexpr int MaxPlanRank = 8;
+
+    /**
+     * @brief Resolved view of a tensor used by an operator record. Strides are
+     * counted in elements and are row-major unless the tensor is a view, see
+     * Kernel::supportsStridedInputs. Dims are logical; a tensor with a blocked
+     * layout has `block > 0` and its strides do not apply, see
+     * TensorObj::getBlock and Kernel::supportsBlockedLayouts.
+     */
+    struct TensorDesc
+    {
+        void *data;
+        DataType dtype;
+        int rank;
+        int block;
+        size_t size;
+        int dims[MaxPlanRank];
+        size_t strides[MaxPlanRank];
+
+        template <typename T>
+        T getPtr() const { return reinterpret_cast<T>(data); }
+    };
+
+    /**
+     * @brief Operator attributes resolved at lowering time. Which member is
+     * valid depends on the op type of the record.
+     */
+    union OpAttrs
+    {
+        struct
+        {
+            int axis;
+        } concat;
+        struct
+        {
+            int permute[MaxPlanRank];
+        } transpose;
+        struct
+        {
+            // Strides of both inputs broadcast to the rank and shape of the
+            // output. A broadcast dimension has stride 0.
+            size_t strides[2][MaxPlanRank];
+        } elementWise;
+        struct
+        {
+            float min, max;
+            bool hasMin, hasMax;
+        } clip;
+        struct
+        {
+            bool transA, transB;
+            int m, n, k;
+            // Epilogue: C = clamp(A * B + bias). `biasStride` is 1 for a bias
+            // of n elements and 0 for a single one.
+            bool hasBias, hasMin, hasMax;
+            size_t biasStride;
+            float min, max;
+            // Batch strides of A and B broadcast to the batch dimensions of
+            // the output, in elements. A broadcast dimension has stride 0.
+            size_t batchStrides[2][MaxPlanRank];
+        } matmul;
+        struct
+        {
+            // Borrowed from the FusedElementWiseObj the record was lowered
+            // from.
+            const FusedStep *program;
+            int length;
+        } fused;
+    };
+
+    /**
+     * @brief One step of an execution plan. A record owns nothing: tensor
+     * descriptors live in the plan, `kernelName` in the kernel registry and
+     * `op` is only kept for diagnostics.
+     */
+    struct OpRecord
+    {
+        const Kernel *kernel;
+        // Resolved by the plan so that replaying it needs no dispatch.
+        KernelFunc func;
+        const char *kernelName;
+        const OperatorObj *op;
+        OpType::underlying_t opType;
+        DataType dtype;
+        int numInputs, numOutputs;
+        // OperatorObj::getFlops for the shapes the record was lowered with.
+        int64_t flops;
+        const TensorDesc *inputs;
+        const TensorDesc *outputs;
+        OpAttrs attrs;
+    };
+
+    static_assert(std::is_trivially_copyable_v<TensorDesc>);
+    static_assert(std::is_trivially_copyable_v<OpRecord>);
+
+} // namespace infini
@@ -16,8 +16,8 @@ namespace infini
         OpType type;
         TensorVec inputs;
         TensorVec outputs;
-        vector<WRef<OperatorObj>> predecessors;
-        vector<WRef<OperatorObj>> successors;
+        WRefList<OperatorObj> predecessors;
+        WRefList<OperatorObj> successors;
 
     public:
         OperatorObj(OpType opType, TensorVec inputs, TensorVec outputs);
@@ -46,8 +46,8 @@ namespace infini
             IT_ASSERT(i < outputs.size(), "Index exceeded");
             return outputs.at(i);
         }
-        OpVec getPredecessors() const { return wrefs_to_refs(predecessors); }
-        OpVec getSuccessors() const { return wrefs_to_refs(successors); }
+        OpVec getPredecessors() const { return predecessors.refs(); }
+        OpVec getSuccessors() const { return successors.refs(); }
         OpType getOpType() const { return type; }
         // HACK: set correct data type
         DataType getDType() const { return getInputs(0)->getDType(); }
@@ -55,6 +55,55 @@ namespace infini
         virtual int numInputs() const = 0;
         virtual int numOutputs() const = 0;
 
+        /**
+         * @brief The returned vector starts with the op type and includes
+         * operator attributes, such as the permutation of Transpose or
+         * transA/transB of Matmul. Input and output shapes are not taken into
+         * consideration.
+         */
+        virtual vector<int> getOpAttrVector() const = 0;
+        /**
+         * @brief Besides operator attributes, the returned vector includes the
+         * data type and the shapes of all inputs.
+         */
+        virtual vector<int> getWorkloadVector() const;
+
+        /**
+         * @brief Estimated floating point operations for the current shapes.
+         * Operators that only move data, such as Transpose, report 0.
+         */
+        virtual int64_t getFlops() const { return 0; }
+        /**
+         * @brief Bytes of all inputs, i.e. the compulsory reads assuming
+         * every input is read from memory once.
+         */
+        virtual int64_t getBytesRead() const;
+        /**
+         * @brief Bytes of all outputs.
+         */
+        virtual int64_t getBytesWritten() const;
+        /**
+         * @brief FLOPs per byte moved, the x-axis of a roofline.
+         */
+        double getArithmeticIntensity() const;
+
+        /**
+         * @brief For ops that only rearrange the elements of their single
+         * input, such as Transpose, the strides of an output that reads the
+         * input in place when the input has `inputStrides`. Other ops return
+         * nullopt.
+         */
+        virtual optional<vector<size_t>>
+        getViewStrides(const vector<size_t> &inputStrides) const
+        {
+            return std::nullopt;
+        }
+        /**
+         * @brief Whether GraphObj::dataMalloc made the output a view of the
+         * input, in which case running the op does nothing.
+         */
+        bool producesView() const;
+
         /**
          * @brief Clone this operator and replace its inputs and outputs.
          *
@@ -70,10 +119,10 @@ namespace infini
         vector<DataType> inferDataType() const;
 
     private:
-        void addPredecessors(const Operator &op) { predecessors.emplace_back(op); }
-        void addSuccessors(const Operator &op) { successors.emplace_back(op); }
-        void removePredecessors(const Operator &op);
-        void removeSuccessors(const Operator &op);
+        void addPredecessors(const Operator &op) { predecessors.add(op); }
+        void addSuccessors(const Operator &op) { successors.add(op); }
+        void removePredecessors(const Operator &op) { predecessors.remove(op); }
+        void removeSuccessors(const Operator &op) { successors.remove(op); }
         void replaceInput(Tensor t1, Tensor t2);
     };
 
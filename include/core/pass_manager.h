@@ -0,0 +1,105 @@
+#pragma once
+#include "core/common.h"
+#include <functional>
+
+namespace infini
+{
+    class GraphObj;
+
+    /**
+     * @brief A graph rewrite. Returns whether it changed the graph.
+     */
+    using GraphPass = std::function<bool(GraphObj &)>;
+
+    /**
+     * @brief Named graph passes. The rewrites of GraphObj are registered as
+     * "fold-constants", "cse", "canonicalize-transpose",
+     * "fuse-matmul-epilogue" and "fuse-element-wise", and the optional
+     * "choose-layouts".
+     */
+    class PassRegistry
+    {
+        std::map<string, GraphPass> passes;
+
+    public:
+        static PassRegistry &getInstance()
+        {
+            static PassRegistry instance;
+            return instance;
+        }
+        bool registerPass(const string &name, GraphPass pass)
+        {
+            IT_ASSERT(passes.count(name) == 0,
+                      "Pass " + name + " already registered");
+            passes.emplace(name, std::move(pass));
+            return true;
+        }
+        bool hasPass(const string &name) const { return passes.count(name); }
+        const GraphPass &getPass(const string &name) const
+        {
+            auto it = passes.find(name);
+            IT_ASSERT(it != passes.end(), "Pass not found: " + name);
+            return it->second;
+        }
+    };
+
+    /**
+     * @brief Accumulated effect of one pass over all iterations of a run.
+     * Removed counts and savings are negative if the pass grew the graph.
+     * Bytes and FLOPs are the static estimates of GraphObj::getBytesMoved
+     * and GraphObj::getFlops.
+     */
+    struct PassStats
+    {
+        string name;
+        int runs = 0, changes = 0;
+        long opsRemoved = 0, tensorsRemoved = 0;
+        long long bytesSaved = 0, flopsSaved = 0;
+        double timeUs = 0;
+    };
+
+    /**
+     * @brief Runs a pipeline of registered passes in order, repeating the
+     * whole pipeline until no pass changes the graph or the iteration limit
+     * is reached.
+     */
+    class PassManager
+    {
+        vector<string> pipeline;
+        int maxIterations;
+        vector<PassStats> stats;
+        int iterations = 0;
+
+    public:
+        /**
+         * @brief The pipeline used by GraphObj::optimize.
+         */
+        static vector<string> defaultPipeline();
+
+        explicit PassManager(vector<string> pipeline = defaultPipeline(),
+                             int maxIterations = 8);
+
+        /**
+         * @brief Runs the pipeline on `graph` and returns whether any pass
+         * changed it. Statistics accumulate over calls.
+         */
+        bool run(GraphObj &graph);
+
+        const vector<PassStats> &getStats() const { return stats; }
+        int getIterations() const { return iterations; }
+        /**
+         * @brief A table with one row per pass.
+         */
+        string summary() const;
+    };
+
+} // namespace infini
+
+#define _REGISTER_PASS_1(name, pass, cnt)                                 \
+    namespace infini                                                      \
+    {                                                                     \
+        static const bool _CAT(_register_pass_, cnt) =                    \
+            PassRegistry::getInstance().registerPass(name, pass);         \
+    }
+
+#define REGISTER_PASS(name, pass) _REGISTER_PASS_1(name, pass, __COUNTER__)
@@ -0,0 +1,75 @@
+#pragma once
+#include "core/kernel.h"
+#include "core/op_record.h"
+#include "core/runtime.h"
+
+namespace infini
+{
+    class ExecutionPlanObj;
+    using ExecutionPlan = Ref<ExecutionPlanObj>;
+
+    /**
+     * @brief Fills `desc` with the data pointer, shape and row-major strides of
+     * `tensor`.
+     */
+    void lowerTensor(const Tensor &tensor, TensorDesc &desc);
+
+    /**
+     * @brief Fills `strides` with the strides of `input` broadcast to the rank
+     * and shape of `output`, aligning shapes to the right. Broadcast and unused
+     * dimensions get stride 0.
+     */
+    void broadcastStrides(const TensorDesc &input, const TensorDesc &output,
+                          size_t *strides);
+
+    /**
+     * @brief Lowers a single operator. `descs` receives the input descriptors
+     * followed by the output descriptors and must not be resized afterwards,
+     * since `record` points into it.
+     */
+    void lowerOperator(const Operator &op, const Kernel *kernel,
+                       vector<TensorDesc> &descs, OpRecord &record);
+
+    /**
+     * @brief An immutable, flattened form of a graph. All kernels, tensor
+     * pointers, shapes and attributes are resolved when the plan is built, so
+     * running it performs no registry lookups and no heap allocation.
+     *
+     * A plan refers to the memory of the graph it was built from and is only
+     * valid as long as that graph is alive and its shapes and data blobs are
+     * unchanged, except for tensors bound with GraphObj::bindExternal, whose
+     * memory is picked up again by updateExternals. Every run writes its
+     * intermediates and outputs into the arena of that graph, so a plan
+     * must not run on several threads at once.
+     */
+    class ExecutionPlanObj
+    {
+        vector<OpRecord> records;
+        vector<TensorDesc> descs;
+        // Descriptors of external tensors, by index into `descs`.
+        vector<std::pair<size_t, Tensor>> externals;
+
+    public:
+        /**
+         * @brief Builds the plan. The graph must be topologically sorted and
+         * its tensors must have data. If `kernels` is given, it names the
+         * kernel of every operator in order instead of choosing one.
+         */
+        explicit ExecutionPlanObj(const GraphObj &graph,
+                                  const vector<string> *kernels = nullptr);
+        ExecutionPlanObj(const ExecutionPlanObj &) = delete;
+        ExecutionPlanObj &operator=(const ExecutionPlanObj &) = delete;
+
+        const vector<OpRecord> &getRecords() const { return records; }
+        size_t size() const { return records.size(); }
+
+        /**
+         * @brief Points the descriptors of external tensors at the memory
+         * currently bound to them. The owner of the plan calls it after
+         * rebinding, never while the plan runs. GraphObj::bindExternal does
+         * it for the captured plan.
+         */
+        void updateExternals();
+    };
+
+} // namespace infini
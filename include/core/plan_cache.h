@@ -0,0 +1,70 @@
+#pragma once
+#include "core/graph.h"
+#include "core/plan.h"
+#include <optional>
+
+namespace infini
+{
+    /**
+     * @brief Caches optimized graphs together with their memory layout and
+     * kernel choices in a directory, keyed by a hash of the model and the
+     * features of the host CPU. A warm start with load() skips optimization,
+     * topological sorting, shape inference, memory planning and kernel
+     * selection: it maps the saved graph, binds its tensors to the saved
+     * offsets and resolves the saved kernels by name.
+     *
+     * Every entry is a graph file written by saveGraph and a small text
+     * file with the memory plan, the kernel names and the name of the graph
+     * file.
+     */
+    class PlanCache
+    {
+        string directory;
+
+        string entryPath(const string &modelHash) const;
+
+    public:
+        struct Entry
+        {
+            Graph graph;
+            ExecutionPlan plan;
+        };
+
+        /**
+         * @brief Uses `directory` for the cache, creating it if needed.
+         */
+        explicit PlanCache(string directory);
+
+        /**
+         * @brief Hashes the bytes of the model file at `path`.
+         */
+        static string modelHash(const string &path);
+        /**
+         * @brief Hashes the structure and constants of `graph`, for models
+         * built in code.
+         */
+        static string modelHash(const Graph &graph);
+        /**
+         * @brief The instruction set extensions the kernels may depend on,
+         * e.g. "avx,avx2,fma".
+         */
+        static string cpuFeatures();
+
+        /**
+         * @brief Stores `graph`, which must be allocated with dataMalloc,
+         * and `plan`, which must be compiled from it, for `modelHash`.
+         * Concurrent stores and loads of the same entry are safe: a load
+         * sees a complete entry or none.
+         */
+        void store(const string &modelHash, const Graph &graph,
+                   const ExecutionPlan &plan) const;
+        /**
+         * @brief Loads the entry for `modelHash` on this CPU, or returns
+         * nullopt if there is none. Tensors keep the order they had in the
+         * stored graph.
+         */
+        std::optional<Entry> load(Runtime runtime,
+                                  const string &modelHash) const;
+    };
+
+} // namespace infini
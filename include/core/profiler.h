@@ -0,0 +1,115 @@
+#pragma once
+#include "core/common.h"
+#include "core/object.h"
+#include "core/op_record.h"
+#include "utils/perf_counter.h"
+#include <chrono>
+
+namespace infini
+{
+    /**
+     * @brief Timing and traffic of one kernel invocation.
+     */
+    struct ProfileEvent
+    {
+        UidBaseType guid;
+        OpType::underlying_t opType;
+        const char *kernelName;
+        double startUs, durationUs; // relative to the first recorded event
+        size_t bytesRead, bytesWritten;
+        size_t flops;
+        // Only valid if hardware counters were enabled for the event.
+        bool hasCounters;
+        PerfCounterValues counters;
+    };
+
+    /**
+     * @brief Opt-in per-op profiler used by the runtime. While disabled the
+     * runtime only pays for one flag check per run.
+     */
+    class Profiler
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Sample
+        {
+            Clock::time_point time;
+            PerfCounterValues counters;
+        };
+
+    private:
+        bool enabled = false;
+        vector<ProfileEvent> events;
+        std::optional<Clock::time_point> origin;
+        PerfCounters perfCounters;
+
+    public:
+        static Profiler &getInstance()
+        {
+            static Profiler instance;
+            return instance;
+        }
+
+        void enable() { enabled = true; }
+        void disable() { enabled = false; }
+        bool isEnabled() const { return enabled; }
+        void clear()
+        {
+            events.clear();
+            origin.reset();
+        }
+
+        /**
+         * @brief Additionally samples cycles, instructions, LLC and branch
+         * counters around every kernel. Returns false if `perf_event_open` is
+         * not available, in which case only wall time is recorded. Call it
+         * before the first parallel kernel runs, since worker threads that
+         * already exist are not counted, see PerfCounters.
+         */
+        bool enableHardwareCounters() { return perfCounters.open(); }
+        void disableHardwareCounters() { perfCounters.close(); }
+        bool hasHardwareCounters() const { return perfCounters.isOpen(); }
+
+        /**
+         * @brief Takes a sample before a kernel runs; `end` records the event.
+         */
+        Sample begin() const
+        {
+            Sample sample;
+            sample.counters = perfCounters.read();
+            // Read the clock last so the counter syscall is not timed.
+            sample.time = Clock::now();
+            return sample;
+        }
+        void end(const OpRecord &record, const Sample &start);
+        const vector<ProfileEvent> &getEvents() const { return events; }
+
+        /**
+         * @brief Aggregates the recorded events per op type into a table of
+         * call counts, time, share of total time, bandwidth and throughput,
+         * plus IPC and miss rates if hardware counters were sampled.
+         */
+        string summary() const;
+        void printSummary() const { std::cout << summary(); }
+
+        /**
+         * @brief One line per recorded event with its hardware counter
+         * derived metrics: IPC, LLC miss rate and branch miss rate.
+         */
+        string counterReport() const;
+
+        /**
+         * @brief Writes the events as Chrome trace JSON, viewable in
+         * chrome://tracing or Perfetto.
+         */
+        void dumpChromeTrace(const string &path) const;
+
+        /**
+         * @brief Floating point operations performed by a record, as
+         * estimated by OperatorObj::getFlops when it was lowered.
+         */
+        static size_t estimateFlops(const OpRecord &record);
+    };
+
+} // namespace infini
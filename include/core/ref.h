@@ -3,6 +3,7 @@
 #include <functional>
 #include <memory>
 #include <type_traits>
+#include <unordered_map>
 
 namespace infini {
 
@@ -40,4 +41,70 @@ std::vector<Ref<T>> wrefs_to_refs(const std::vector<WRef<T>> &wrefs) {
     return refs;
 }
 
+/**
+ * @brief A multiset of weak references, keyed by address and kept in a
+ * vector. Adding a reference and removing all occurrences of one are O(1);
+ * removal moves the last distinct element into the freed slot.
+ */
+template <typename T> class WRefList {
+    struct Entry {
+        WRef<T> ref;
+        const T *ptr;
+        int count;
+    };
+    std::vector<Entry> entries;
+    std::unordered_map<const T *, size_t> index;
+    size_t total = 0;
+
+  public:
+    void add(const Ref<T> &ref) {
+        auto [it, inserted] = index.try_emplace(ref.get(), entries.size());
+        if (inserted) {
+            entries.push_back({ref, ref.get(), 1});
+        } else if (auto &entry = entries[it->second]; entry.ref.expired()) {
+            // A dead object's address was reused.
+            total -= entry.count;
+            entry = {ref, ref.get(), 1};
+        } else {
+            entry.count++;
+        }
+        total++;
+    }
+
+    // Removes every occurrence of `ref`.
+    void remove(const Ref<T> &ref) {
+        auto it = index.find(ref.get());
+        if (it == index.end())
+            return;
+        size_t pos = it->second;
+        index.erase(it);
+        total -= entries[pos].count;
+        if (pos + 1 != entries.size()) {
+            entries[pos] = std::move(entries.back());
+            index[entries[pos].ptr] = pos;
+        }
+        entries.pop_back();
+    }
+
+    void clear() {
+        entries.clear();
+        index.clear();
+        total = 0;
+    }
+
+    // The number of occurrences, counting duplicates.
+    size_t size() const { return total; }
+    bool empty() const { return total == 0; }
+
+    // All references, with an element added n times repeated n times.
+    std::vector<Ref<T>> refs() const {
+        std::vector<Ref<T>> ret;
+        ret.reserve(total);
+        for (const auto &entry : entries)
+            if (auto ref = entry.ref.lock())
+                ret.insert(ret.end(), entry.count, ref);
+        return ret;
+    }
+};
+
 } // namespace infini
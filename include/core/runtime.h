@@ -10,12 +10,14 @@ namespace infini
   class GraphObj;
   class RuntimeObj;
   class BlobObj;
+  class ExecutionPlanObj;
 
   using Tensor = Ref<TensorObj>;
   using Operator = Ref<OperatorObj>;
   using Graph = Ref<GraphObj>;
   using Runtime = Ref<RuntimeObj>;
   using Blob = Ref<BlobObj>;
+  using ExecutionPlan = Ref<ExecutionPlanObj>;
 
   using TensorVec = vector<Tensor>;
   using OpVec = vector<Operator>;
@@ -38,9 +40,16 @@ namespace infini
     virtual ~RuntimeObj() {}
 
     virtual void run(const Graph &graph) const = 0;
+    /**
+     * @brief Runs a plan built by GraphObj::compile. No heap allocation is
+     * performed.
+     */
+    virtual void run(const ExecutionPlan &plan) const = 0;
     virtual void *alloc(size_t size) = 0;
     virtual void dealloc(void *ptr) = 0;
 
+    Device getDevice() const { return device; }
+
     bool isCpu() const
     {
       return true;
@@ -62,6 +71,7 @@ namespace infini
     }
     void dealloc(void *ptr) override;
     void run(const Graph &graph) const override;
+    void run(const ExecutionPlan &plan) const override;
     void *alloc(size_t size) override;
     string toString() const override;
   };
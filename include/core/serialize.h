@@ -0,0 +1,25 @@
+#pragma once
+#include "core/graph.h"
+
+namespace infini
+{
+    /**
+     * @brief Writes `graph` to `path` in a compact binary format: a header,
+     * the shapes, data types and layouts of all tensors, the operators in
+     * topological order with their attribute vectors, and then the data of
+     * constant tensors, each payload aligned to 64 bytes. Data of other
+     * tensors is not stored.
+     */
+    void saveGraph(const Graph &graph, const string &path);
+
+    /**
+     * @brief Reads a graph written by saveGraph. The file is mapped into
+     * memory and constant tensors refer to the mapped pages directly, so
+     * loading costs O(metadata) and processes loading the same file share
+     * its pages. The mapping is private: writes to a constant only affect
+     * this process. It is unmapped once no constant refers to it. The graph
+     * is already topologically sorted.
+     */
+    Graph loadGraph(Runtime runtime, const string &path);
+
+} // namespace infini
@@ -3,6 +3,7 @@
 #include "core/data_type.h"
 #include "core/object.h"
 #include "core/runtime.h"
+#include "utils/compare.h"
 #include <cmath>
 #include <cstring>
 #include <fstream>
@@ -20,14 +21,19 @@ namespace infini
         int dim;
 
         DataType dtype;
-        vector<WRef<OperatorObj>> targets;
+        WRefList<OperatorObj> targets;
         WRef<OperatorObj> source;
         Blob data;
         Runtime runtime;
+        bool constant = false;
 
     private:
         Shape shape;
         size_t _size; // Cache of Π(shape).
+        vector<size_t> viewStrides; // Empty unless the tensor is a view.
+        size_t viewOffset = 0;
+        int block = 0; // Layout tag, see getBlock.
+        bool external = false; // See GraphObj::bindExternal.
         Fuid fuid;    // Cloned tensors share the same id. Tensors constructed from
                       // scratch have a new id.
 
@@ -37,10 +43,15 @@ namespace infini
         string toString() const override;
 
         size_t size() const { return _size; }
-        size_t getBytes() const { return _size * dtype.getSize(); }
+        size_t getBytes() const { return getPhysicalSize() * dtype.getSize(); }
+        /**
+         * @brief The number of elements stored, which exceeds size() by the
+         * padding of a blocked layout.
+         */
+        size_t getPhysicalSize() const;
 
         Shape getDims() const { return shape; }
-        void setShape(Shape shape_);
+        void setShape(const Shape &shape_);
         size_t getRank() const { return shape.size(); }
         UidBaseType getFuid() const { return fuid; }
 
@@ -49,7 +60,77 @@ namespace infini
 
         void setDataBlob(const Blob &blob);
 
+        /**
+         * @brief Strides of the data in elements. They are row-major unless
+         * the tensor is a view.
+         */
+        vector<size_t> getStrides() const;
+        /**
+         * @brief Makes the tensor a view of the data of `base` starting at
+         * byte `offset`, read with `strides`, so that nothing is copied.
+         * Reshaping the tensor or binding other data ends the view.
+         */
+        void setView(const Tensor &base, vector<size_t> strides,
+                     size_t offset = 0);
+        bool isView() const { return !viewStrides.empty(); }
+        /**
+         * @brief The byte offset of a view into the data of its base.
+         */
+        size_t getOffset() const { return viewOffset; }
+        bool isContiguous() const;
+
+        /**
+         * @brief The memory layout. 0 is plain row-major. A blocked layout
+         * splits the last axis into blocks of `block` elements, e.g. the
+         * SIMD width, and stores each block as a [rows, block] panel over
+         * the second to last axis: a [..., R, C] tensor is stored as
+         * [..., ceil(C / block), R, block] with the last block zero padded.
+         * A matmul reads such a B operand with one vector load per row.
+         * Only kernels that support blocked layouts accept these tensors.
+         */
+        int getBlock() const { return block; }
+        bool isBlocked() const { return block > 0; }
+        /**
+         * @brief Sets the layout of a tensor that has no data yet.
+         */
+        void setBlock(int block);
+
+        /**
+         * @brief Marks the tensor as a constant, e.g. a weight, and gives it
+         * zeroed storage of its own. Constant tensors are left out of the
+         * memory arena of the graph, and operators whose inputs are all
+         * constant can be evaluated ahead of time by
+         * GraphObj::foldConstants.
+         */
+        void setConstant();
+        /**
+         * @brief Marks the tensor as a constant with data from `generator`.
+         */
+        void setConstant(
+            std::function<void(void *, size_t, DataType)> const &generator);
+        /**
+         * @brief Marks the tensor as a constant with getBytes() bytes copied
+         * from `src`.
+         */
+        void setConstant(const void *src);
+        /**
+         * @brief Marks the tensor as a constant whose data is `blob`, which
+         * must hold getBytes() bytes. Nothing is copied.
+         */
+        void setConstant(const Blob &blob);
+        bool isConstant() const { return constant; }
+        /**
+         * @brief Whether the data is caller-owned memory bound with
+         * GraphObj::bindExternal.
+         */
+        bool isExternal() const { return external; }
+
         void printData() const;
+        /**
+         * @brief Compares the data with that of `rhs`, see compareData.
+         */
+        CompareResult compare(const Tensor &rhs,
+                              double relativeError = 1e-6) const;
         bool equalData(const Tensor &rhs, double relativeError = 1e-6) const;
 
         template <typename T>
@@ -57,7 +138,9 @@ namespace infini
         {
             IT_ASSERT(size() == dataVector.size());
             IT_ASSERT(DataType::get<T>() == dtype.cpuTypeInt());
-            return equalDataImpl(getRawDataPtr<T *>(), dataVector.data(), size());
+            IT_ASSERT(isContiguous() && !isBlocked());
+            return reportEqual(compareData(getRawDataPtr<void *>(),
+                                           dataVector.data(), size(), dtype));
         }
 
         template <typename T>
@@ -72,7 +155,12 @@ namespace infini
         DataType getDType() const { return dtype; }
         Runtime getRuntime() const { return runtime; }
 
-        OpVec getTargets() const { return wrefs_to_refs(targets); }
+        OpVec getTargets() const { return targets.refs(); }
+        /**
+         * @brief The number of uses of this tensor, same as
+         * getTargets().size().
+         */
+        size_t getNumTargets() const { return targets.size(); }
         Operator getSource() const { return source.lock(); }
 
     private:
@@ -111,54 +199,15 @@ namespace infini
             return builder.str();
         }
 
-        template <typename T>
-        bool equalDataImpl(const T *a, const T *b, size_t size,
-                           double relativeError = 1e-6) const
+        static bool reportEqual(const CompareResult &result);
+        void clearView()
         {
-            for (size_t i = 0; i < size; ++i)
-            {
-                if constexpr (std::is_integral_v<T>)
-                {
-                    if (a[i] != b[i])
-                        return false;
-                }
-                else if constexpr (std::is_floating_point_v<T>)
-                {
-                    if (std::min(fabs(a[i]), fabs(b[i])) == 0. &&
-                        fabs(a[i] - b[i]) > relativeError)
-                    {
-                        printf("Error on %lu: %f %f\n", i, a[i], b[i]);
-                        return false;
-                    }
-                    else if (std::min(fabs(a[i]), fabs(b[i])) != 0. &&
-                             fabs(a[i] - b[i]) /
-                                     std::max(fabs(a[i]), fabs(b[i])) >
-                                 relativeError)
-                    {
-                        printf("Error on %lu: %f %f\n", i, a[i], b[i]);
-                        return false;
-                    }
-                }
-                else
-                {
-                    static_assert(!sizeof(T), "Unsupported data type");
-                }
-            }
-            return true;
+            viewStrides.clear();
+            viewOffset = 0;
         }
-
-        void addTarget(const Operator &op) { targets.emplace_back(op); }
+        void addTarget(const Operator &op) { targets.add(op); }
         void setSource(const Operator &op) { source = op; }
-        void removeTarget(const Operator &op)
-        {
-            for (auto itr = targets.begin(); itr != targets.end();)
-            {
-                if (itr->lock() == op)
-                    itr = targets.erase(itr);
-                else
-                    ++itr;
-            }
-        }
+        void removeTarget(const Operator &op) { targets.remove(op); }
     };
 
 } // namespace infini
@@ -28,7 +28,9 @@ namespace infini
     std::string toString() const override;
     int numInputs() const override { return 2; }
     int numOutputs() const override { return 1; }
-    };
+    vector<int> getOpAttrVector() const override;
+    int64_t getFlops() const override { return outputs[0]->size(); }
+  };
 
 #define DEFINE_ELEMENT_WISE_OBJ(prefix, type)                    \
   class prefix##Obj : public ElementWiseObj                      \
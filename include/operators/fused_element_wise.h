@@ -0,0 +1,68 @@
+#pragma once
+#include "core/op_record.h"
+#include "core/operator.h"
+
+namespace infini
+{
+  /**
+   * @brief One step of a fused element-wise program. Programs are postfix
+   * and run on a value stack: a step with `input >= 0` pushes that input,
+   * otherwise `opType` (Add, Sub, Mul, Div, Relu or Clip) pops its operands
+   * and pushes the result.
+   */
+  struct FusedStep
+  {
+    OpType::underlying_t opType;
+    int input;
+    float min, max;
+    bool hasMin, hasMax;
+  };
+
+  static_assert(std::is_trivially_copyable_v<FusedStep>);
+
+  /**
+   * @brief A tree of element-wise and unary operators evaluated in a single
+   * pass over memory. Inputs are the leaves of the tree and may broadcast to
+   * the output shape; every intermediate value has the output shape and is
+   * never written to memory. Created by GraphObj::fuseElementWise.
+   */
+  class FusedElementWiseObj : public OperatorObj
+  {
+  public:
+    // Limits of the CPU kernel, which keeps its stack and input cursors in
+    // fixed-size arrays.
+    static constexpr int MaxInputs = 8;
+    static constexpr int MaxStackDepth = 8;
+
+    /**
+     * @brief Construct a new FusedElementWise object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param inputs The leaves of the fused expression.
+     * @param output The output tensor.
+     * @param program The postfix program computing the output.
+     */
+    FusedElementWiseObj(GraphObj *graph, TensorVec inputs, Tensor output,
+                        vector<FusedStep> program);
+    OP_CLONE(FusedElementWiseObj);
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return inputs.size(); }
+    int numOutputs() const override { return 1; }
+    const vector<FusedStep> &getProgram() const { return program; }
+    vector<int> getOpAttrVector() const override;
+    /**
+     * @brief One operation per output element for every non-load step.
+     */
+    int64_t getFlops() const override;
+
+    /**
+     * @brief The deepest value stack reached while running `program`.
+     */
+    static int stackDepth(const vector<FusedStep> &program);
+
+  private:
+    vector<FusedStep> program;
+  };
+} // namespace infini
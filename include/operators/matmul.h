@@ -15,6 +15,10 @@ namespace infini
         // oppsite to the column-major BLAS.
         bool transA, transB;
 
+        // Epilogue clamp applied after the optional bias. Relu is a clamp
+        // with min 0.
+        std::optional<float> clampMin, clampMax;
+
         // Auxiliary attributes which are not a part of operator attributes.
         int m, n, k;
 
@@ -37,9 +41,12 @@ namespace infini
          * the constructor, C should be an empty Ref.
          * @param transA If matrix A should be transposed when computing.
          * @param transB If matrix B should be transposed when computing.
+         * @param bias Optional bias added to every row of C. It has either n
+         * elements or a single one, and all dimensions but the last are 1.
          */
         MatmulObj(GraphObj *graph, Tensor A, Tensor B, Tensor C,
-                  bool transA = false, bool transB = false);
+                  bool transA = false, bool transB = false,
+                  Tensor bias = nullptr);
         OP_CLONE(MatmulObj);
 
         std::string toString() const override;
@@ -52,9 +59,33 @@ namespace infini
         bool getTransB() const { return transB; }
         void setTransA(bool transA) { this->transA = transA; }
         void setTransB(bool transB) { this->transB = transB; }
+        bool hasBias() const { return inputs.size() > 2; }
+        Tensor getBias() const { return hasBias() ? inputs[2] : nullptr; }
+        /**
+         * @brief Whether `bias` can be added to the output by the epilogue,
+         * i.e. it broadcasts along the rows of C without enlarging it.
+         */
+        bool isValidBias(const Tensor &bias) const;
+        std::optional<float> getClampMin() const { return clampMin; }
+        std::optional<float> getClampMax() const { return clampMax; }
+        void setClamp(std::optional<float> min, std::optional<float> max)
+        {
+            clampMin = min;
+            clampMax = max;
+        }
+        bool hasClamp() const
+        {
+            return clampMin.has_value() || clampMax.has_value();
+        }
         int getM() const { return m; }
         int getN() const { return n; }
         int getK() const { return k; }
+        vector<int> getOpAttrVector() const override;
+        /**
+         * @brief 2 * M * N * K per batch, plus one operation per output
+         * element for the bias and for the clamp.
+         */
+        int64_t getFlops() const override;
     };
 
 } // namespace infini
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+  /**
+   * @brief Copies a tensor into another memory layout, see
+   * TensorObj::getBlock. The output has the shape of the input and the
+   * layout given by `block`. Inserted by GraphObj::chooseLayouts.
+   */
+  class ReorderObj : public OperatorObj
+  {
+  public:
+    ReorderObj(GraphObj *graph, Tensor input, Tensor output, int block);
+    OP_CLONE(ReorderObj);
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return 1; }
+    int numOutputs() const override { return 1; }
+    int getBlock() const { return block; }
+    vector<int> getOpAttrVector() const override;
+
+  private:
+    int block;
+  };
+
+} // namespace infini
@@ -24,6 +24,8 @@ namespace infini
     std::string toString() const override;
     int numInputs() const override { return 1; }
     int numOutputs() const override { return 1; }
+    vector<int> getOpAttrVector() const override;
+    int64_t getFlops() const override { return outputs[0]->size(); }
   };
 
   class ClipObj : public OperatorObj
@@ -39,6 +41,8 @@ namespace infini
     std::optional<float> getMax() const { return maxValue; };
     int numInputs() const override { return 1; }
     int numOutputs() const override { return 1; }
+    vector<int> getOpAttrVector() const override;
+    int64_t getFlops() const override { return outputs[0]->size(); }
 
   private:
     std::optional<float> minValue, maxValue;
@@ -86,6 +90,7 @@ namespace infini
     DataType getOutputDataType() const;
     int numInputs() const override { return 1; }
     int numOutputs() const override { return 1; }
+    vector<int> getOpAttrVector() const override;
 
   private:
     CastType castType;
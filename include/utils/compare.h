@@ -0,0 +1,39 @@
+#pragma once
+#include "core/data_type.h"
+
+namespace infini {
+
+/**
+ * @brief How two buffers of the same data type differ. Errors of floating
+ * point types are measured in the precision of the values, so Float16 and
+ * BFloat16 are widened to float first; integers compare exactly.
+ */
+struct CompareResult {
+    size_t size = 0;
+    size_t mismatches = 0;
+    double maxAbsError = 0;
+    double maxRelError = 0;
+    // Largest distance in units in the last place, i.e. the number of
+    // representable values between the two. Integers count their difference.
+    uint64_t maxUlpError = 0;
+    // Indices of the first mismatches, in increasing order.
+    vector<size_t> mismatchIndices;
+
+    bool equal() const { return mismatches == 0; }
+    string toString() const;
+};
+
+/**
+ * @brief Compares `size` elements of `a` and `b`, which hold `dtype`. Two
+ * floating point values match when their relative error is within
+ * `relativeError`, or their absolute error is when one of them is zero; NaN
+ * only matches NaN. At most `maxIndices` mismatch indices are kept.
+ *
+ * The buffers are split into blocks that are compared in parallel with
+ * OpenMP, and each block is reduced in a loop that the compiler vectorizes.
+ */
+CompareResult compareData(const void *a, const void *b, size_t size,
+                          DataType dtype, double relativeError = 1e-6,
+                          size_t maxIndices = 16);
+
+} // namespace infini
@@ -1,5 +1,7 @@
 #pragma once
 #include "core/common.h"
+#include "core/data_type.h"
+#include <array>
 #include <random>
 
 namespace infini {
@@ -56,4 +58,65 @@ template <int val> class ValGenerator : public DataGenerator {
 };
 typedef ValGenerator<1> OneGenerator;
 typedef ValGenerator<0> ZeroGenerator;
+
+/**
+ * @brief One block of the Philox4x32-10 counter-based generator: four random
+ * words that only depend on `counter` and `key`.
+ */
+std::array<uint32_t, 4> philox4x32(std::array<uint32_t, 4> counter,
+                                   std::array<uint32_t, 2> key);
+
+/**
+ * @brief Fills data with random values drawn with Philox4x32-10. Element i
+ * only depends on the seed and i, so the data is the same for any number of
+ * threads and any size it is a prefix of. The data is filled in parallel
+ * with OpenMP and converted in vectorizable loops.
+ *
+ * Every numeric DataType is supported: Float16 and BFloat16 round to
+ * nearest, Bool is whether the sample is nonzero, and other types convert
+ * like static_cast, so the samples have to fit them.
+ */
+class RandomGenerator {
+  public:
+    enum class Distribution { Uniform, Normal, IntRange };
+
+  private:
+    Distribution distribution;
+    double a, b;         // [low, high) or mean and standard deviation
+    int64_t low, high;   // for IntRange, inclusive
+    uint64_t seed;
+
+  protected:
+    RandomGenerator(Distribution distribution, double a, double b,
+                    int64_t low, int64_t high, uint64_t seed)
+        : distribution(distribution), a(a), b(b), low(low), high(high),
+          seed(seed) {}
+
+  public:
+    virtual ~RandomGenerator() {}
+    void operator()(void *data, size_t size, DataType dataType) const;
+};
+
+// Real numbers uniform in [low, high).
+class UniformGenerator : public RandomGenerator {
+  public:
+    UniformGenerator(double low = 0, double high = 1, uint64_t seed = 0)
+        : RandomGenerator(Distribution::Uniform, low, high, 0, 0, seed) {}
+};
+
+// Real numbers from a normal distribution.
+class NormalGenerator : public RandomGenerator {
+  public:
+    NormalGenerator(double mean = 0, double stddev = 1, uint64_t seed = 0)
+        : RandomGenerator(Distribution::Normal, mean, stddev, 0, 0, seed) {}
+};
+
+// Integers uniform in [low, high], up to a negligible modulo bias.
+class IntRangeGenerator : public RandomGenerator {
+  public:
+    IntRangeGenerator(int64_t low, int64_t high, uint64_t seed = 0)
+        : RandomGenerator(Distribution::IntRange, 0, 0, low, high, seed) {
+        IT_ASSERT(low <= high);
+    }
+};
 } // namespace infini
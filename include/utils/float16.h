@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+namespace infini {
+
+// Conversions between float and the 16-bit floating point formats, which are
+// stored as uint16_t. Narrowing conversions round to nearest even.
+
+inline float bf16ToFloat(uint16_t val) {
+    uint32_t bits = (uint32_t)val << 16;
+    float ret;
+    std::memcpy(&ret, &bits, sizeof(ret));
+    return ret;
+}
+
+inline uint16_t floatToBf16(float val) {
+    uint32_t bits;
+    std::memcpy(&bits, &val, sizeof(bits));
+    if ((bits & 0x7fffffff) > 0x7f800000) // NaN
+        return (bits >> 16) | 0x40;
+    bits += 0x7fff + ((bits >> 16) & 1);
+    return bits >> 16;
+}
+
+inline float fp16ToFloat(uint16_t val) {
+    uint32_t sign = (uint32_t)(val & 0x8000) << 16;
+    uint32_t exp = (val >> 10) & 0x1f;
+    uint32_t mant = val & 0x3ff;
+    uint32_t bits;
+    if (exp == 0x1f) // Inf or NaN
+        bits = sign | 0x7f800000 | (mant << 13);
+    else if (exp != 0)
+        bits = sign | ((exp + 112) << 23) | (mant << 13);
+    else if (mant == 0)
+        bits = sign;
+    else {
+        // Subnormal: normalize the mantissa.
+        exp = 113;
+        while (!(mant & 0x400)) {
+            mant <<= 1;
+            --exp;
+        }
+        bits = sign | (exp << 23) | ((mant & 0x3ff) << 13);
+    }
+    float ret;
+    std::memcpy(&ret, &bits, sizeof(ret));
+    return ret;
+}
+
+inline uint16_t floatToFp16(float val) {
+    uint32_t bits;
+    std::memcpy(&bits, &val, sizeof(bits));
+    uint16_t sign = (bits >> 16) & 0x8000;
+    uint32_t absBits = bits & 0x7fffffff;
+    if (absBits > 0x7f800000) // NaN
+        return sign | 0x7e00;
+    if (absBits >= 0x477ff000) // Rounds to infinity
+        return sign | 0x7c00;
+    if (absBits < 0x38800000) {
+        // Subnormal or zero: align the implicit bit, then round.
+        if (absBits < 0x33000000)
+            return sign;
+        uint32_t exp = absBits >> 23;
+        uint32_t mant = (absBits & 0x7fffff) | 0x800000;
+        uint32_t shift = 126 - exp;
+        uint32_t half = 1u << (shift - 1);
+        uint32_t rest = mant & ((1u << shift) - 1);
+        uint32_t ret = mant >> shift;
+        if (rest > half || (rest == half && (ret & 1)))
+            ++ret;
+        return sign | ret;
+    }
+    absBits += 0xfff + ((absBits >> 13) & 1);
+    return sign | ((absBits - 0x38000000) >> 13);
+}
+
+} // namespace infini
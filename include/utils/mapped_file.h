@@ -0,0 +1,14 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace infini {
+
+// Maps the file at `path` into memory and stores its size in `size`. The
+// mapping is private: pages are shared with the page cache until written,
+// and writes are never seen by other processes. It is unmapped when the
+// last copy of the returned pointer is gone.
+std::shared_ptr<void> mapFile(const std::string &path, size_t &size);
+
+} // namespace infini
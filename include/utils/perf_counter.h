@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+
+namespace infini {
+
+/**
+ * @brief Raw hardware counter values. Values are cumulative while counters
+ * are read; subtract two samples to get the counts of an interval.
+ */
+struct PerfCounterValues {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t llcReferences = 0;
+    uint64_t llcMisses = 0;
+    uint64_t branches = 0;
+    uint64_t branchMisses = 0;
+
+    PerfCounterValues operator-(const PerfCounterValues &rhs) const;
+    PerfCounterValues &operator+=(const PerfCounterValues &rhs);
+
+    double ipc() const {
+        return cycles ? double(instructions) / cycles : 0.;
+    }
+    double llcMissRate() const {
+        return llcReferences ? double(llcMisses) / llcReferences : 0.;
+    }
+    double branchMissRate() const {
+        return branches ? double(branchMisses) / branches : 0.;
+    }
+};
+
+/**
+ * @brief Hardware performance counters read through Linux
+ * `perf_event_open`. All events are opened as one group so that a single
+ * `read` returns a consistent sample.
+ *
+ * The counters follow the thread that opens them and, where the kernel
+ * allows it (see isInherited), the threads it creates afterwards. Threads
+ * that already exist are never counted: open the counters before the first
+ * parallel region starts the OpenMP workers, or the work they do is missed.
+ */
+class PerfCounters {
+  public:
+    static constexpr int NumEvents = 6;
+
+  private:
+    int fds[NumEvents];
+    bool opened = false;
+    bool inherited = false;
+
+    bool openGroup(bool inherit);
+
+  public:
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    /**
+     * @brief Opens and starts the counters for the calling thread. Returns
+     * false if the platform or `perf_event_paranoid` does not allow it.
+     */
+    bool open();
+    void close();
+    bool isOpen() const { return opened; }
+    /**
+     * @brief Whether threads created after open are counted too.
+     */
+    bool isInherited() const { return inherited; }
+
+    PerfCounterValues read() const;
+};
+
+} // namespace infini
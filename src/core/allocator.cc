@@ -7,6 +7,7 @@ namespace infini
     {
         used = 0;
         peak = 0;
+        top = 0;
         ptr = nullptr;
 
         // 'alignment' defaults to sizeof(uint64_t), because it is the length of
@@ -44,13 +45,26 @@ namespace infini
                     freeBlocks[addr + size] = addr_size;
                 }
                 this->used += size;
-                this->peak = std::max(this->used, this->peak);
                 return addr;
             }
         }
 
-        throw std::runtime_error("No enough memory");
-        return 0;
+        // No hole fits: grow the arena, reusing a free block that ends at
+        // the top.
+        size_t addr = this->top;
+        if (!freeBlocks.empty())
+        {
+            auto last = std::prev(freeBlocks.end());
+            if (last->first + last->second == this->top)
+            {
+                addr = last->first;
+                freeBlocks.erase(last);
+            }
+        }
+        this->top = addr + size;
+        this->used += size;
+        this->peak = std::max(this->top, this->peak);
+        return addr;
     }
 
     void Allocator::free(size_t addr, size_t size)
@@ -102,7 +116,15 @@ namespace infini
         }
 
         // 更新内存使用统计
-        used -= alignedSize;
+        used -= getAlignedSize(size);
+
+        // 顶部的空闲块归还给未分配区域
+        auto last = std::prev(freeBlocks.end());
+        if (last->first + last->second == this->top)
+        {
+            this->top = last->first;
+            freeBlocks.erase(last);
+        }
     }
 
     void *Allocator::getPtr()
@@ -115,6 +137,19 @@ namespace infini
         return this->ptr;
     }
 
+    void Allocator::reset()
+    {
+        if (this->ptr != nullptr)
+        {
+            runtime->dealloc(this->ptr);
+            this->ptr = nullptr;
+        }
+        freeBlocks.clear();
+        used = 0;
+        peak = 0;
+        top = 0;
+    }
+
     size_t Allocator::getAlignedSize(size_t size)
     {
         return ((size - 1) / this->alignment + 1) * this->alignment;
@@ -0,0 +1,88 @@
+#include "core/autotuner.h"
+#include "core/plan.h"
+#include <chrono>
+#include <fstream>
+
+namespace infini
+{
+    void Autotuner::setCacheFile(const string &path)
+    {
+        cachePath = path;
+        std::ifstream ifs(path);
+        string line;
+        while (std::getline(ifs, line))
+        {
+            auto pos = line.rfind('\t');
+            if (pos == string::npos)
+                continue;
+            cache[line.substr(0, pos)] = line.substr(pos + 1);
+        }
+    }
+
+    void Autotuner::save() const
+    {
+        if (cachePath.empty())
+            return;
+        std::ofstream ofs(cachePath);
+        IT_ASSERT(ofs.is_open(), "Cannot open " + cachePath);
+        for (const auto &[key, name] : cache)
+            ofs << key << '\t' << name << '\n';
+    }
+
+    string Autotuner::workloadKey(const KernelAttrs &attrs, const Operator &op)
+    {
+        return get_kernel_attrs_str(attrs) + " " +
+               vecToString(op->getWorkloadVector());
+    }
+
+    const KernelRegistry::KernelRecord &
+    Autotuner::select(const KernelAttrs &attrs, const Operator &op)
+    {
+        const auto &registry = KernelRegistry::getInstance();
+        const auto &candidates = registry.getKernelItems(attrs);
+        if (candidates.size() == 1)
+            return candidates.front();
+
+        auto key = workloadKey(attrs, op);
+        if (auto it = cache.find(key); it != cache.end())
+            if (auto item = registry.getKernelItem(attrs, it->second))
+                return *item;
+
+        using Clock = std::chrono::steady_clock;
+        const RuntimeObj *context = op->getOutput()->getRuntime().get();
+        const KernelRegistry::KernelRecord *best = nullptr;
+        double bestTime = 0;
+        for (const auto &candidate : candidates)
+        {
+            vector<TensorDesc> descs;
+            OpRecord record;
+            lowerOperator(op, std::get<0>(candidate), descs, record);
+            KernelFunc func = std::get<0>(candidate)->resolve(record);
+            if (!func)
+                continue;
+            for (int i = 0; i < warmup; ++i)
+                func(record, context);
+            double time = 0;
+            for (int i = 0; i < repeat; ++i)
+            {
+                auto start = Clock::now();
+                func(record, context);
+                double t = std::chrono::duration<double>(Clock::now() - start)
+                               .count();
+                time = i == 0 ? t : std::min(time, t);
+            }
+            if (!best || time < bestTime)
+            {
+                best = &candidate;
+                bestTime = time;
+            }
+        }
+        // No candidate implements the data type; the default one reports it.
+        if (!best)
+            return candidates.front();
+        cache[key] = std::get<1>(*best);
+        save();
+        return *best;
+    }
+
+} // namespace infini
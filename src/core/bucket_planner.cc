@@ -0,0 +1,252 @@
+#include "core/bucket_planner.h"
+#include "core/blob.h"
+#include "core/runtime.h"
+#include <cstring>
+
+namespace infini
+{
+    void BucketPlanner::addSymbol(const string &name, const Tensor &tensor,
+                                  int axis)
+    {
+        IT_ASSERT(buckets.empty(), "Symbols must be added before plan()");
+        IT_ASSERT(graph->hasTensor(tensor) && !tensor->getSource(),
+                  "Symbol " + name + " must bind a graph input");
+        IT_ASSERT(axis >= 0 && axis < (int)tensor->getRank());
+        for (auto &symbol : symbols)
+            if (symbol.name == name)
+            {
+                symbol.bindings.push_back({tensor, axis});
+                return;
+            }
+        symbols.push_back({name, {{tensor, axis}}, {}});
+    }
+
+    void BucketPlanner::setBuckets(const string &name, vector<int> sizes)
+    {
+        IT_ASSERT(buckets.empty(), "Buckets must be set before plan()");
+        for (auto &symbol : symbols)
+            if (symbol.name == name)
+            {
+                std::sort(sizes.begin(), sizes.end());
+                sizes.erase(std::unique(sizes.begin(), sizes.end()),
+                            sizes.end());
+                IT_ASSERT(!sizes.empty() && sizes.front() > 0);
+                symbol.buckets = std::move(sizes);
+                return;
+            }
+        IT_ASSERT(false, "Symbol not found: " + name);
+    }
+
+    vector<int> BucketPlanner::powersOfTwo(int min, int max)
+    {
+        IT_ASSERT(0 < min && min <= max);
+        vector<int> sizes;
+        int size = 1;
+        while (size < min)
+            size *= 2;
+        for (; size < max; size *= 2)
+            sizes.push_back(size);
+        sizes.push_back(max);
+        return sizes;
+    }
+
+    void BucketPlanner::plan()
+    {
+        IT_ASSERT(buckets.empty(), "plan() can only be called once");
+        IT_ASSERT(graph->topo_sort());
+        for (auto &symbol : symbols)
+        {
+            const auto &binding = symbol.bindings[0];
+            if (symbol.buckets.empty())
+                symbol.buckets = {binding.tensor->getDims()[binding.axis]};
+        }
+        tensors = graph->getTensors();
+        for (size_t i = 0; i < tensors.size(); ++i)
+            tensorIndex.emplace(tensors[i].get(), i);
+
+        // Enumerate the combinations with the last symbol varying fastest,
+        // which is the order select() indexes them in.
+        auto runtime = graph->getRuntime();
+        vector<size_t> choice(symbols.size(), 0);
+        vector<vector<size_t>> offsets;
+        for (bool more = true; more;)
+        {
+            Bucket bucket;
+            for (size_t s = 0; s < symbols.size(); ++s)
+                bucket.values.push_back(symbols[s].buckets[choice[s]]);
+            inferShapes(bucket.values);
+
+            Allocator allocator(runtime);
+            vector<size_t> offset(tensors.size(), 0);
+            for (size_t i = 0; i < tensors.size(); ++i)
+            {
+                bucket.shapes.push_back(tensors[i]->getDims());
+                if (!tensors[i]->isConstant())
+                    offset[i] = allocator.alloc(tensors[i]->getBytes());
+            }
+            arenaSize = std::max(arenaSize, allocator.getPeak());
+            offsets.emplace_back(std::move(offset));
+            buckets.emplace_back(std::move(bucket));
+
+            more = false;
+            for (int s = (int)symbols.size() - 1; s >= 0; --s)
+            {
+                if (++choice[s] < symbols[s].buckets.size())
+                {
+                    more = true;
+                    break;
+                }
+                choice[s] = 0;
+            }
+        }
+
+        arena = make_ref<BlobObj>(runtime, std::max(arenaSize, size_t(1)));
+        auto base = arena->getPtr<char *>();
+        for (size_t b = 0; b < buckets.size(); ++b)
+        {
+            auto &bucket = buckets[b];
+            bucket.blobs.resize(tensors.size());
+            for (size_t i = 0; i < tensors.size(); ++i)
+                if (!tensors[i]->isConstant())
+                    bucket.blobs[i] =
+                        make_ref<BlobObj>(runtime, base + offsets[b][i]);
+            // Operators such as MatMul lower attributes computed by shape
+            // inference, so each bucket is inferred again before compiling.
+            inferShapes(bucket.values);
+            bind(bucket);
+            bucket.plan = graph->compile();
+        }
+        current = buckets.size() - 1;
+    }
+
+    void BucketPlanner::inferShapes(const vector<int> &values)
+    {
+        for (size_t s = 0; s < symbols.size(); ++s)
+            for (const auto &binding : symbols[s].bindings)
+            {
+                auto shape = binding.tensor->getDims();
+                shape[binding.axis] = values[s];
+                graph->setShape(binding.tensor, shape);
+            }
+        graph->shape_infer();
+    }
+
+    void BucketPlanner::bind(const Bucket &bucket)
+    {
+        for (size_t i = 0; i < tensors.size(); ++i)
+        {
+            if (tensors[i]->getDims() != bucket.shapes[i])
+                tensors[i]->setShape(bucket.shapes[i]);
+            if (bucket.blobs[i])
+                tensors[i]->setDataBlob(bucket.blobs[i]);
+        }
+        graph->invalidatePlan();
+    }
+
+    const ExecutionPlan &BucketPlanner::select(const vector<int> &values)
+    {
+        IT_ASSERT(!buckets.empty(), "plan() has not been called");
+        IT_ASSERT(values.size() == symbols.size());
+        size_t index = 0;
+        for (size_t s = 0; s < symbols.size(); ++s)
+        {
+            const auto &sizes = symbols[s].buckets;
+            auto it = std::lower_bound(sizes.begin(), sizes.end(), values[s]);
+            IT_ASSERT(it != sizes.end(),
+                      "No bucket of " + symbols[s].name + " fits " +
+                          std::to_string(values[s]));
+            index = index * sizes.size() + (it - sizes.begin());
+        }
+        if ((int)index != current)
+        {
+            bind(buckets[index]);
+            current = index;
+        }
+        return buckets[index].plan;
+    }
+
+    void BucketPlanner::copyPadded(const Tensor &tensor, const void *src,
+                                   const Shape &shape)
+    {
+        const auto &dims = tensor->getDims();
+        const int rank = dims.size();
+        IT_ASSERT((int)shape.size() == rank);
+        for (int d = 0; d < rank; ++d)
+            IT_ASSERT(0 <= shape[d] && shape[d] <= dims[d]);
+        auto dst = tensor->getRawDataPtr<char *>();
+        auto from = static_cast<const char *>(src);
+        const size_t elem = tensor->getDType().getSize();
+        std::memset(dst, 0, tensor->getBytes());
+        if (rank == 0)
+        {
+            std::memcpy(dst, from, elem);
+            return;
+        }
+        size_t rows = 1;
+        for (int d = 0; d < rank - 1; ++d)
+            rows *= shape[d];
+        const size_t row = shape[rank - 1] * elem;
+        if (rows == 0 || row == 0)
+            return;
+
+        vector<size_t> stride(rank, elem);
+        for (int d = rank - 2; d >= 0; --d)
+            stride[d] = stride[d + 1] * dims[d + 1];
+        vector<int> index(rank, 0);
+        size_t offset = 0;
+        for (size_t r = 0; r < rows; ++r)
+        {
+            std::memcpy(dst + offset, from + r * row, row);
+            for (int d = rank - 2; d >= 0; --d)
+            {
+                offset += stride[d];
+                if (++index[d] < shape[d])
+                    break;
+                offset -= stride[d] * shape[d];
+                index[d] = 0;
+            }
+        }
+    }
+
+    vector<string> BucketPlanner::getSymbolicShape(const Tensor &tensor) const
+    {
+        IT_ASSERT(!buckets.empty(), "plan() has not been called");
+        auto it = tensorIndex.find(tensor.get());
+        IT_ASSERT(it != tensorIndex.end());
+        const size_t t = it->second;
+        vector<string> ret;
+        for (size_t axis = 0; axis < tensor->getRank(); ++axis)
+        {
+            auto value = [&](size_t b) { return buckets[b].shapes[t][axis]; };
+            bool fixed = true;
+            for (size_t b = 1; b < buckets.size(); ++b)
+                fixed &= value(b) == value(0);
+            if (fixed)
+            {
+                ret.push_back(std::to_string(value(0)));
+                continue;
+            }
+            string name = "?";
+            for (size_t s = 0; s < symbols.size() && name == "?"; ++s)
+            {
+                int scale = value(0) / buckets[0].values[s];
+                bool follows = scale > 0;
+                for (size_t b = 0; b < buckets.size() && follows; ++b)
+                    follows = value(b) == scale * buckets[b].values[s];
+                if (follows)
+                    name = scale == 1 ? symbols[s].name
+                                      : std::to_string(scale) + "*" +
+                                            symbols[s].name;
+            }
+            ret.push_back(name);
+        }
+        return ret;
+    }
+
+    const vector<int> &BucketPlanner::getBucket() const
+    {
+        IT_ASSERT(current >= 0, "plan() has not been called");
+        return buckets[current].values;
+    }
+
+} // namespace infini
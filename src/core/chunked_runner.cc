@@ -0,0 +1,170 @@
+#include "core/chunked_runner.h"
+#include "core/runtime.h"
+#include "operators/concat.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include <cstring>
+
+namespace infini
+{
+    namespace
+    {
+        using IsChunked = std::function<bool(const Tensor &)>;
+
+        // Whether rows of the leading axis of the chunked inputs of `op` map
+        // to rows of the leading axis of its output and nothing else does.
+        bool isRowIndependent(const Operator &op, const IsChunked &isChunked)
+        {
+            const auto &inputs = op->getInputs();
+            const size_t rank = op->getOutput()->getRank();
+            // A chunked input shares the leading axis of the output; any
+            // other input must broadcast along it.
+            auto aligned = [&](const Tensor &input)
+            {
+                return isChunked(input) ? input->getRank() == rank
+                                        : input->getRank() < rank ||
+                                              input->getDims()[0] == 1;
+            };
+            switch (op->getOpType().underlying())
+            {
+            case OpType::Add:
+            case OpType::Sub:
+            case OpType::Mul:
+            case OpType::Div:
+            case OpType::FusedElementWise:
+                return std::all_of(inputs.begin(), inputs.end(), aligned);
+            case OpType::Relu:
+            case OpType::Clip:
+            case OpType::Cast:
+            case OpType::Reorder:
+                return true;
+            case OpType::Transpose:
+                return as<TransposeObj>(op)->getPermute()[0] == 0;
+            case OpType::Concat:
+                return as<ConcatObj>(op)->getDim() != 0 &&
+                       std::all_of(inputs.begin(), inputs.end(), isChunked);
+            case OpType::MatMul:
+            {
+                auto matmul = as<MatmulObj>(op);
+                // Rows of A are rows of the output unless A is transposed;
+                // beyond rank 2 the leading axis is a batch axis of both.
+                auto A = inputs[0], B = inputs[1];
+                bool rowsOfA = rank == 2 && !matmul->getTransA() &&
+                               A->getRank() == 2 && !isChunked(B);
+                bool batch = rank > 2 && aligned(A) && aligned(B);
+                return (rowsOfA || batch) &&
+                       !(matmul->hasBias() && isChunked(matmul->getBias()));
+            }
+            default:
+                return false;
+            }
+        }
+    } // namespace
+
+    ChunkedRunner::ChunkedRunner(Graph graph, size_t chunkRows)
+        : graph(std::move(graph)), chunkRows(chunkRows)
+    {
+        IT_ASSERT(chunkRows > 0);
+        IT_ASSERT(isChunkable(this->graph),
+                  "Graph does not treat rows independently");
+        for (const auto &input : this->graph->getInputs())
+            if (!input->isConstant())
+                inputs.emplace_back(input);
+        outputs = this->graph->getOutputs();
+    }
+
+    bool ChunkedRunner::isChunkable(const Graph &graph)
+    {
+        IT_ASSERT(graph->topo_sort());
+        std::unordered_set<const TensorObj *> chunked;
+        IsChunked isChunked = [&](const Tensor &tensor)
+        { return chunked.count(tensor.get()) > 0; };
+        for (const auto &input : graph->getInputs())
+            if (!input->isConstant())
+            {
+                if (input->getRank() == 0 || input->isBlocked())
+                    return false;
+                chunked.insert(input.get());
+            }
+        for (const auto &op : graph->getOperators())
+        {
+            const auto &opInputs = op->getInputs();
+            // Ops on constants only are the same for every chunk.
+            if (std::none_of(opInputs.begin(), opInputs.end(), isChunked))
+                continue;
+            if (!isRowIndependent(op, isChunked))
+                return false;
+            for (const auto &output : op->getOutputs())
+                chunked.insert(output.get());
+        }
+        for (const auto &output : graph->getOutputs())
+            if (!isChunked(output) || output->isBlocked())
+                return false;
+        return true;
+    }
+
+    void ChunkedRunner::prepare(size_t rows)
+    {
+        if (rows == plannedRows)
+            return;
+        for (const auto &input : inputs)
+        {
+            auto shape = input->getDims();
+            shape[0] = rows;
+            graph->setShape(input, shape);
+        }
+        graph->shape_infer();
+        graph->dataMalloc();
+        plan = graph->compile();
+        plannedRows = rows;
+        arenaSize = std::max(arenaSize, graph->getMemoryPlan().size);
+    }
+
+    void ChunkedRunner::run(size_t totalRows, const Source &source,
+                            const Sink &sink)
+    {
+        const auto runtime = graph->getRuntime();
+        for (size_t row = 0; row < totalRows; row += chunkRows)
+        {
+            const size_t rows = std::min(chunkRows, totalRows - row);
+            prepare(rows);
+            for (const auto &input : inputs)
+                source(input, row, rows, input->getRawDataPtr<void *>());
+            runtime->run(plan);
+            for (const auto &output : outputs)
+                sink(output, row, rows, output->getRawDataPtr<void *>());
+        }
+    }
+
+    ChunkedRunner::Source
+    ChunkedRunner::fromBuffers(vector<const void *> buffers) const
+    {
+        IT_ASSERT(buffers.size() == inputs.size());
+        return [inputs = inputs, buffers = std::move(buffers)](
+                   const Tensor &input, size_t row, size_t rows, void *data)
+        {
+            auto i = std::find(inputs.begin(), inputs.end(), input) -
+                     inputs.begin();
+            size_t rowBytes = input->getBytes() / rows;
+            std::memcpy(data,
+                        static_cast<const char *>(buffers[i]) + row * rowBytes,
+                        rows * rowBytes);
+        };
+    }
+
+    ChunkedRunner::Sink ChunkedRunner::toBuffers(vector<void *> buffers) const
+    {
+        IT_ASSERT(buffers.size() == outputs.size());
+        return [outputs = outputs, buffers = std::move(buffers)](
+                   const Tensor &output, size_t row, size_t rows,
+                   const void *data)
+        {
+            auto i = std::find(outputs.begin(), outputs.end(), output) -
+                     outputs.begin();
+            size_t rowBytes = output->getBytes() / rows;
+            std::memcpy(static_cast<char *>(buffers[i]) + row * rowBytes,
+                        data, rows * rowBytes);
+        };
+    }
+
+} // namespace infini
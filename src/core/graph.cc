@@ -1,16 +1,26 @@
 #include "core/graph.h"
+#include "core/pass_manager.h"
+#include "core/plan.h"
 #include <algorithm>
+#include <deque>
+#include <iomanip>
 #include <numeric>
 #include <queue>
+#include "operators/fused_element_wise.h"
 #include "operators/matmul.h"
+#include "operators/reorder.h"
 #include "operators/transpose.h"
+#include "operators/unary.h"
 namespace infini
 {
 
     void GraphObj::addOperatorAndConnect(const Operator &op)
     {
         sorted = false;
-        ops.push_back(op);
+        invalidatePlan();
+        // An operator removed before compaction is still in `ops`.
+        if (opIndex.insert(op.get()).second && !removedOps.erase(op.get()))
+            ops.push_back(op);
         for (auto &input : op->getInputs())
         {
             if (input)
@@ -37,15 +47,117 @@ namespace infini
         }
     }
 
+    void GraphObj::detachOperator(const Operator &op)
+    {
+        invalidatePlan();
+        for (auto &input : op->getInputs())
+            input->removeTarget(op);
+        for (auto &output : op->getOutputs())
+            if (output->getSource() == op)
+                output->setSource(nullptr);
+        for (auto &pred : op->getPredecessors())
+            pred->removeSuccessors(op);
+        for (auto &succ : op->getSuccessors())
+            succ->removePredecessors(op);
+        op->predecessors.clear();
+        op->successors.clear();
+        removeOperatorLazily(op);
+    }
+
+    void GraphObj::absorbConsumer(const Operator &op, const Operator &consumer)
+    {
+        auto oldOutput = op->getOutput();
+        auto newOutput = consumer->getOutput();
+        detachOperator(consumer);
+        removeTensorLazily(oldOutput);
+        op->outputs[0] = newOutput;
+        newOutput->setSource(op);
+        for (auto &succ : newOutput->getTargets())
+        {
+            succ->addPredecessors(op);
+            op->addSuccessors(succ);
+        }
+    }
+
+    void GraphObj::connectInput(const Operator &op, const Tensor &tensor)
+    {
+        invalidatePlan();
+        sorted = false;
+        op->inputs.emplace_back(tensor);
+        tensor->addTarget(op);
+        if (auto pred = tensor->getSource())
+        {
+            pred->addSuccessors(op);
+            op->addPredecessors(pred);
+        }
+    }
+
+    void GraphObj::redirectInput(const Operator &op, const Tensor &from,
+                                 const Tensor &to)
+    {
+        invalidatePlan();
+        sorted = false;
+        const auto &inputs = op->getInputs();
+        auto uses = std::count(inputs.begin(), inputs.end(), from);
+        op->replaceInput(from, to);
+        from->removeTarget(op);
+        auto oldPred = from->getSource();
+        if (oldPred && std::none_of(inputs.begin(), inputs.end(),
+                                    [&](const Tensor &t)
+                                    { return t->getSource() == oldPred; }))
+        {
+            oldPred->removeSuccessors(op);
+            op->removePredecessors(oldPred);
+        }
+        auto newPred = to->getSource();
+        for (int i = 0; i < uses; ++i)
+        {
+            to->addTarget(op);
+            if (newPred)
+            {
+                newPred->addSuccessors(op);
+                op->addPredecessors(newPred);
+            }
+        }
+    }
+
+    void GraphObj::replaceAllUses(const Tensor &from, const Tensor &to)
+    {
+        auto targets = from->getTargets();
+        for (size_t i = 0; i < targets.size(); ++i)
+            if (std::find(targets.begin(), targets.begin() + i, targets[i]) ==
+                targets.begin() + i)
+                redirectInput(targets[i], from, to);
+    }
+
+    void GraphObj::removeDeadCone(const Tensor &tensor, TensorVec *touched)
+    {
+        auto source = tensor->getSource();
+        if (!source || !tensor->getTargets().empty())
+            return;
+        const auto outputs = source->getOutputs();
+        for (const auto &output : outputs)
+            if (!output->getTargets().empty())
+                return;
+        const auto inputs = source->getInputs();
+        detachOperator(source);
+        for (const auto &output : outputs)
+            removeTensorLazily(output);
+        if (touched)
+            touched->insert(touched->end(), inputs.begin(), inputs.end());
+        for (const auto &input : inputs)
+            removeDeadCone(input, touched);
+    }
+
     string GraphObj::toString() const
     {
         std::ostringstream oss;
         oss << "Graph Tensors:\n";
-        for (const auto &tensor : tensors)
+        for (const auto &tensor : getTensors())
             oss << tensor << "\n";
 
         oss << "Graph operators:\n";
-        for (const auto &op : ops)
+        for (const auto &op : getOperators())
         {
             vector<UidBaseType> preds, succs;
             for (auto &o : op->getPredecessors())
@@ -60,345 +172,949 @@ namespace infini
         return oss.str();
     }
 
+    void GraphObj::compact()
+    {
+        if (!removedTensors.empty())
+        {
+            tensors.erase(std::remove_if(tensors.begin(), tensors.end(),
+                                         [&](const Tensor &t)
+                                         { return !hasTensor(t); }),
+                          tensors.end());
+            removedTensors.clear();
+        }
+        if (!removedOps.empty())
+        {
+            ops.erase(std::remove_if(ops.begin(), ops.end(),
+                                     [&](const Operator &op)
+                                     { return !hasOperator(op); }),
+                      ops.end());
+            removedOps.clear();
+        }
+    }
+
     bool GraphObj::topo_sort()
     {
+        compact();
         if (this->sorted)
         {
             return true;
         }
-        std::vector<Operator> sorted;
-        std::unordered_set<OperatorObj *> flags;
-        sorted.reserve(ops.size());
-        flags.reserve(ops.size());
-        while (sorted.size() < ops.size())
+        const auto &current = getOperators();
+        const size_t n = current.size();
+        std::unordered_map<const OperatorObj *, size_t> position;
+        position.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+            position.emplace(current[i].get(), i);
+
+        // Edges are derived from the inputs so that the sort does not depend
+        // on the bookkeeping of targets and successors.
+        vector<int> indegree(n, 0);
+        vector<vector<size_t>> consumers(n);
+        for (size_t i = 0; i < n; ++i)
+            for (const auto &input : current[i]->getInputs())
+                if (auto source = input->getSource())
+                    if (auto it = position.find(source.get());
+                        it != position.end())
+                    {
+                        consumers[it->second].emplace_back(i);
+                        indegree[i]++;
+                    }
+
+        OpVec sorted;
+        sorted.reserve(n);
+        vector<size_t> queue;
+        queue.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+            if (indegree[i] == 0)
+                queue.emplace_back(i);
+        for (size_t head = 0; head < queue.size(); ++head)
+        {
+            sorted.emplace_back(current[queue[head]]);
+            for (size_t consumer : consumers[queue[head]])
+                if (--indegree[consumer] == 0)
+                    queue.emplace_back(consumer);
+        }
+        if (sorted.size() < n)
         {
-            // Any node is move to sorted in this loop.
-            auto modified = false;
-            for (auto const &op : ops)
-            {
-                if (auto const &inputs = op->getInputs();
-                    flags.find(op.get()) == flags.end() &&
-                    std::all_of(inputs.begin(), inputs.end(),
-                                [&flags](auto const &input)
-                                {
-                                    auto ptr = input->getSource().get();
-                                    return !ptr || flags.find(ptr) != flags.end();
-                                }))
-                {
-                    modified = true;
-                    sorted.emplace_back(op);
-                    flags.insert(op.get());
-                }
-            }
-            if (!modified)
-            {
-                return false;
-            }
+            return false;
         }
         this->ops = std::move(sorted);
+        opOrder.clear();
+        for (size_t i = 0; i < n; ++i)
+            opOrder.emplace(this->ops[i].get(), i);
         return this->sorted = true;
     }
 
-    bool isInverse(const TransposeObj &self, const TransposeObj &other)
+    void GraphObj::markSorted()
     {
-        auto self_permute = self.getPermute();
-        auto other_permute = other.getPermute();
-        for (int i = 0; i < (int)self_permute.size(); ++i)
+        compact();
+        const auto &current = getOperators();
+        opOrder.clear();
+        for (size_t i = 0; i < current.size(); ++i)
+            opOrder.emplace(current[i].get(), i);
+        sorted = true;
+    }
+
+    void GraphObj::optimize()
+    {
+        IT_ASSERT(topo_sort(), "Graph is not topologically sorted, optimize failed!");
+        PassManager().run(*this);
+    }
+
+    bool GraphObj::foldConstants()
+    {
+        IT_ASSERT(topo_sort(), "Graph is not topologically sorted");
+        const auto &registry = KernelRegistry::getInstance();
+        bool changed = false;
+        // Ops are visited in topological order, so the outputs of a folded
+        // op can make its consumers foldable in the same sweep.
+        const OpVec order = getOperators();
+        for (const auto &op : order)
         {
-            if (self_permute[other_permute[i]] != i)
+            const auto inputs = op->getInputs();
+            auto kernelAttrs =
+                KernelAttrs{runtime->getDevice(), op->getOpType().underlying()};
+            if (inputs.empty() ||
+                !std::all_of(inputs.begin(), inputs.end(),
+                             [](const Tensor &t)
+                             { return t->isConstant(); }) ||
+                !registry.hasKernel(kernelAttrs))
+                continue;
+
+            // Lower onto fresh storage and keep the op if its kernel does not
+            // implement the data type, e.g. an Int32 Add.
+            Kernel *kernel = registry.getKernel(kernelAttrs);
+            const auto &outputs = op->getOutputs();
+            vector<Blob> blobs;
+            for (const auto &output : outputs)
             {
-                return false;
+                blobs.emplace_back(
+                    make_ref<BlobObj>(runtime, output->getBytes()));
+                output->setDataBlob(blobs.back());
+            }
+            vector<TensorDesc> descs;
+            OpRecord record;
+            lowerOperator(op, kernel, descs, record);
+            KernelFunc func = kernel->resolve(record);
+            if (!func)
+            {
+                for (const auto &output : outputs)
+                    output->setDataBlob(nullptr);
+                continue;
             }
+            for (size_t i = 0; i < outputs.size(); ++i)
+                outputs[i]->setConstant(blobs[i]);
+            func(record, runtime.get());
+            detachOperator(op);
+            // Constants only read by folded ops are no longer needed.
+            for (const auto &input : inputs)
+                if (input->getNumTargets() == 0 && !input->getSource() &&
+                    hasTensor(input))
+                    removeTensorLazily(input);
+            changed = true;
         }
-        return true;
+        compact();
+        return changed;
     }
 
-    int isTransMat(const TransposeObj &self)
+    namespace
     {
-        auto permute = self.getPermute();
-        auto rank = permute.size();
-        if (rank <= 1)
-        {
-            return -1;
-        }
-        for (int i = 0; i < (int)rank - 2; ++i)
+        struct OpKeyHash
         {
-            if (permute[i] != i)
+            size_t operator()(const vector<int> &key) const
             {
-                return -1;
+                size_t ret = key.size();
+                for (int v : key)
+                    ret ^= std::hash<int>()(v) + 0x9e3779b9 + (ret << 6) +
+                           (ret >> 2);
+                return ret;
             }
+        };
+    } // namespace
+
+    bool GraphObj::eliminateCommonSubexpressions()
+    {
+        IT_ASSERT(topo_sort(), "Graph is not topologically sorted");
+        // Two ops are equivalent when they have the same type and attributes
+        // and read the same tensors in the same order.
+        std::unordered_map<vector<int>, Operator, OpKeyHash> seen;
+        bool changed = false;
+        const OpVec order = getOperators();
+        for (const auto &op : order)
+        {
+            auto attrs = op->getOpAttrVector();
+            vector<int> key{(int)attrs.size()};
+            key.insert(key.end(), attrs.begin(), attrs.end());
+            for (const auto &input : op->getInputs())
+                key.emplace_back(input->getFuid());
+
+            auto [it, inserted] = seen.try_emplace(key, op);
+            if (inserted)
+                continue;
+            // Graph outputs are kept, so their producers cannot be merged.
+            const auto &outputs = op->getOutputs();
+            if (std::any_of(outputs.begin(), outputs.end(),
+                            [](const Tensor &t)
+                            { return t->getTargets().empty(); }))
+                continue;
+            const auto &kept = it->second->getOutputs();
+            for (size_t i = 0; i < outputs.size(); ++i)
+                replaceAllUses(outputs[i], kept[i]);
+            removeDeadCone(outputs[0]);
+            changed = true;
         }
-        return permute[rank - 1] == (int)rank - 1 ? 0 : 1;
+        compact();
+        return changed;
     }
 
-    void GraphObj::optimize()
+    // Transposing by `first` and then by `second` is a single transpose by
+    // the returned permutation.
+    static vector<int> composePermute(const vector<int> &first,
+                                      const vector<int> &second)
     {
-        // =================================== 作业 ===================================
-        // TODO: 设计一个算法来实现指定的图优化规则
-        // 图优化规则如下：
-        // 1. 去除冗余的算子（例如，两个相邻的算子都是 transpose 算子，且做的是相反的操作，可以将其全部删除）
-        // 2. 合并算子（例如，矩阵乘算子中含有属性transA、transB，如果其输入存在transpose，且对最后两个维度做交换，就可以将transpose融入到矩阵乘算子的属性中去）
-        // =================================== 作业 ===================================
-        // 前置校验：确保计算图拓扑有序（从输入到输出的顺序遍历）
-        IT_ASSERT(topo_sort(), "Graph is not topologically sorted, optimize failed!");
+        vector<int> ret(second.size());
+        for (size_t i = 0; i < second.size(); ++i)
+            ret[i] = first[second[i]];
+        return ret;
+    }
 
-        std::vector<Operator> remove_ops;   // 待删除算子
-        std::vector<Tensor> remove_tensors; // 待删除张量
-        std::vector<Tensor> wait_for_cut;   // 待递归清理的无消费者张量
+    static bool isIdentityPermute(const vector<int> &permute)
+    {
+        for (size_t i = 0; i < permute.size(); ++i)
+            if (permute[i] != (int)i)
+                return false;
+        return true;
+    }
+
+    // Whether `permute` only swaps the last two axes.
+    static bool isMatrixTranspose(const vector<int> &permute)
+    {
+        int rank = permute.size();
+        if (rank < 2)
+            return false;
+        for (int i = 0; i < rank - 2; ++i)
+            if (permute[i] != i)
+                return false;
+        return permute[rank - 2] == rank - 1 && permute[rank - 1] == rank - 2;
+    }
 
-        // -------------------------- 优化1：移除相邻反向Transpose（从后继出发） --------------------------
-        // 遍历所有算子，通过"当前算子的后继"寻找连续Transpose
-        for (auto const &curr_op : ops)
+    static bool isLayoutAgnostic(const Operator &op)
+    {
+        switch (op->getOpType().underlying())
         {
-            // 若当前算子不是Transpose，跳过（我们关注"Transpose → 后继Transpose"的模式）
-            if (curr_op->getOpType() != OpType::Transpose)
-            {
-                continue;
-            }
+        case OpType::Add:
+        case OpType::Sub:
+        case OpType::Mul:
+        case OpType::Div:
+        case OpType::Relu:
+        case OpType::Clip:
+        case OpType::Cast:
+            return true;
+        default:
+            return false;
+        }
+    }
 
-            // 从当前算子的后继中寻找Transpose（核心：从后继出发）
-            for (auto const &succ_op : curr_op->getSuccessors())
-            {
-                // 若后继不是Transpose，跳过
-                if (succ_op->getOpType() != OpType::Transpose)
-                {
-                    continue;
-                }
+    bool GraphObj::rewriteTranspose(const Operator &op, TensorVec &touched)
+    {
+        auto transpose = as<TransposeObj>(op);
+        auto input = op->getInputs(0), output = op->getOutput();
+        auto permute = transpose->getPermute();
 
-                // 校验两个Transpose是否互逆（当前算子curr_op → 后继succ_op）
-                auto trans_curr = static_cast<TransposeObj *>(curr_op.get());
-                auto trans_succ = static_cast<TransposeObj *>(succ_op.get());
-                if (!isInverse(*trans_curr, *trans_succ))
-                {
-                    continue; // 非反向操作，不优化
-                }
+        // Transpose(Transpose(x, p), q) -> Transpose(x, p o q)
+        if (auto pred = input->getSource();
+            pred && pred->getOpType() == OpType::Transpose)
+        {
+            auto composed =
+                composePermute(as<TransposeObj>(pred)->getPermute(), permute);
+            detachOperator(op);
+            addOpWithOutputs<TransposeObj>(pred->getInputs(0), output,
+                                           composed);
+            touched.insert(touched.end(), {pred->getInputs(0), input, output});
+            removeDeadCone(input, &touched);
+            return true;
+        }
 
-                // 关键张量：
-                // curr_input（当前Transpose的输入）→ curr_output（当前的输出）→ succ_output（后继的输出）
-                auto curr_input = curr_op->getInputs()[0];
-                auto curr_output = curr_op->getOutputs()[0];
-                auto succ_output = succ_op->getOutputs()[0];
-                auto succ_successors = succ_op->getSuccessors(); // 后继的后继（最终要接回curr_input）
+        // Transpose(x, identity) -> x, unless it produces a graph output.
+        if (isIdentityPermute(permute))
+        {
+            if (output->getTargets().empty())
+                return false;
+            replaceAllUses(output, input);
+            touched.emplace_back(input);
+            removeDeadCone(output, &touched);
+            return true;
+        }
 
-                // 步骤1：断开当前算子与后继算子的依赖
-                curr_op->removeSuccessors(succ_op);
-                succ_op->removePredecessors(curr_op);
+        // MatMul(Transpose(x), ...) -> MatMul(x, ...) with transA/transB
+        // flipped, when only the last two axes are swapped.
+        bool changed = false;
+        if (isMatrixTranspose(permute))
+            for (const auto &succ : output->getTargets())
+            {
+                if (succ->getOpType() != OpType::MatMul)
+                    continue;
+                auto matmul = as<MatmulObj>(succ);
+                const auto &inputs = succ->getInputs();
+                if (inputs[0] == output && inputs[1] == output)
+                    continue;
+                if (inputs[0] == output)
+                    matmul->setTransA(!matmul->getTransA());
+                else if (inputs[1] == output)
+                    matmul->setTransB(!matmul->getTransB());
+                else
+                    continue;
+                redirectInput(succ, output, input);
+                changed = true;
+            }
+        if (changed)
+        {
+            touched.insert(touched.end(), {input, output});
+            removeDeadCone(output, &touched);
+        }
+        return changed;
+    }
 
-                // 步骤2：断开后继算子与它的后继的依赖
-                for (auto const &nxt_op : succ_successors)
-                {
-                    succ_op->removeSuccessors(nxt_op);
-                    nxt_op->removePredecessors(succ_op);
-                }
+    bool GraphObj::sinkTranspose(const Operator &op, TensorVec &touched)
+    {
+        // Only sink below `op` when every consumer is a Transpose that the
+        // sunk one can be composed with.
+        auto output = op->getOutput();
+        const auto targets = output->getTargets();
+        if (!isLayoutAgnostic(op) || targets.empty() ||
+            std::any_of(targets.begin(), targets.end(), [](const Operator &t)
+                        { return t->getOpType() != OpType::Transpose; }))
+            return false;
 
-                // 步骤3：重建依赖（跳过两个Transpose）
-                // 让当前Transpose的输入直接对接后继的后继
-                for (auto const &nxt_op : succ_successors)
-                {
-                    // 更新后继的后继的输入：从succ_output改为curr_input
-                    nxt_op->replaceInput(succ_output, curr_input);
-                    // 更新后继的后继的前驱：从succ_op改为curr_op的前驱
-                    if (!curr_op->getPredecessors().empty())
-                    {
-                        auto curr_prev = curr_op->getPredecessors()[0];
-                        nxt_op->addPredecessors(curr_prev);
-                        curr_prev->addSuccessors(nxt_op);
-                    }
-                    // 更新curr_input的消费者：添加后继的后继
-                    curr_input->addTarget(nxt_op);
-                }
+        // Every input is either a single-use Transpose by one common
+        // permutation with the output shape, or a single element.
+        optional<vector<int>> permute;
+        TensorVec newInputs;
+        Shape newShape;
+        for (const auto &input : op->getInputs())
+        {
+            auto pred = input->getSource();
+            if (pred && pred->getOpType() == OpType::Transpose &&
+                input->getTargets().size() == 1 &&
+                input->getDims() == output->getDims())
+            {
+                auto p = as<TransposeObj>(pred)->getPermute();
+                if (permute && *permute != p)
+                    return false;
+                permute = p;
+                newInputs.emplace_back(pred->getInputs(0));
+                newShape = pred->getInputs(0)->getDims();
+            }
+            else if (input->size() == 1 &&
+                     input->getRank() <= output->getRank())
+                newInputs.emplace_back(input);
+            else
+                return false;
+        }
+        if (!permute)
+            return false;
 
-                // 步骤4：清理中间张量的依赖
-                curr_output->removeTarget(succ_op); // curr_output不再被succ_op使用
-                curr_input->removeTarget(curr_op);  // curr_input不再被curr_op使用
+        // op(Transpose(x, p), ...) -> Transpose(op(x, ...), p)
+        auto oldInputs = op->getInputs();
+        detachOperator(op);
+        auto newOutput = addTensor(newShape, output->getDType());
+        addOperatorAndConnect(op->clone(newInputs, {newOutput}));
+        addOpWithOutputs<TransposeObj>(newOutput, output, *permute);
+        touched.insert(touched.end(), newInputs.begin(), newInputs.end());
+        touched.insert(touched.end(), oldInputs.begin(), oldInputs.end());
+        touched.insert(touched.end(), {newOutput, output});
+        for (const auto &input : oldInputs)
+            removeDeadCone(input, &touched);
+        return true;
+    }
 
-                // 步骤5：标记待删除对象
-                remove_ops.push_back(curr_op); // 删除当前Transpose
-                remove_ops.push_back(succ_op); // 删除后继Transpose
-                remove_tensors.push_back(curr_output);
-                remove_tensors.push_back(succ_output);
+    bool GraphObj::canonicalizeTranspose()
+    {
+        // A rewrite can only enable further rewrites at the producers and
+        // consumers of the tensors it touched, so only those are revisited.
+        compact();
+        std::deque<Operator> worklist(ops.begin(), ops.end());
+        std::unordered_set<const OperatorObj *> queued;
+        for (const auto &op : ops)
+            queued.insert(op.get());
+        auto push = [&](const Operator &op)
+        {
+            if (op && hasOperator(op) && queued.insert(op.get()).second)
+                worklist.emplace_back(op);
+        };
 
-                // 若中间张量无其他消费者，加入递归清理队列
-                if (curr_output->getTargets().empty())
-                {
-                    wait_for_cut.push_back(curr_output);
-                }
-                if (succ_output->getTargets().empty())
-                {
-                    wait_for_cut.push_back(succ_output);
-                }
+        bool changed = false;
+        TensorVec touched;
+        while (!worklist.empty())
+        {
+            auto op = worklist.front();
+            worklist.pop_front();
+            queued.erase(op.get());
+            if (!hasOperator(op))
+                continue;
+            touched.clear();
+            bool progress = op->getOpType() == OpType::Transpose
+                                ? rewriteTranspose(op, touched)
+                                : sinkTranspose(op, touched);
+            if (!progress)
+                continue;
+            changed = true;
+            for (const auto &tensor : touched)
+            {
+                push(tensor->getSource());
+                for (const auto &target : tensor->getTargets())
+                    push(target);
             }
         }
+        compact();
+        return changed;
+    }
 
-        // -------------------------- 优化2：合并Transpose到MatMul（从后继出发） --------------------------
-        for (auto const &curr_op : ops)
+    static Operator soleConsumer(const Tensor &tensor)
+    {
+        auto targets = tensor->getTargets();
+        return targets.size() == 1 ? targets[0] : nullptr;
+    }
+
+    bool GraphObj::fuseMatmulEpilogue()
+    {
+        bool changed = false;
+        const OpVec order = getOperators();
+        for (const auto &op : order)
         {
-            // 若当前算子不是Transpose，跳过（我们关注"Transpose → 后继MatMul"的模式）
-            if (curr_op->getOpType() != OpType::Transpose)
-            {
+            if (op->getOpType() != OpType::MatMul)
                 continue;
-            }
+            auto matmul = as<MatmulObj>(op);
+            if (matmul->hasClamp())
+                continue;
+            auto output = matmul->getOutput();
+            auto consumer = soleConsumer(output);
 
-            // 从当前Transpose的后继中寻找MatMul（核心：从后继出发）
-            for (auto const &succ_op : curr_op->getSuccessors())
+            if (consumer && consumer->getOpType() == OpType::Add &&
+                !matmul->hasBias())
             {
-                if (succ_op->getOpType() != OpType::MatMul)
-                {
-                    continue; // 后继不是MatMul，跳过
-                }
-                auto matmul_op = static_cast<MatmulObj *>(succ_op.get());
-
-                // 校验Transpose是否仅交换最后两个维度
-                auto trans_obj = static_cast<TransposeObj *>(curr_op.get());
-                int is_last_two = isTransMat(*trans_obj);
-                if (is_last_two != 1)
+                const auto &inputs = consumer->getInputs();
+                auto bias = inputs[0] == output ? inputs[1] : inputs[0];
+                if (consumer->getOutput()->getDims() == output->getDims() &&
+                    matmul->isValidBias(bias))
                 {
-                    continue; // 不符合合并条件
+                    absorbConsumer(matmul, consumer);
+                    connectInput(matmul, bias);
+                    changed = true;
+                    consumer = soleConsumer(matmul->getOutput());
                 }
+            }
 
-                // 关键张量：
-                // trans_input（Transpose的输入）→ trans_output（Transpose的输出）→ MatMul的输入
-                auto trans_input = curr_op->getInputs()[0];
-                auto trans_output = curr_op->getOutputs()[0];
+            if (consumer && consumer->getOpType() == OpType::Relu)
+                matmul->setClamp(0.f, std::nullopt);
+            else if (consumer && consumer->getOpType() == OpType::Clip)
+            {
+                auto clip = as<ClipObj>(consumer);
+                matmul->setClamp(clip->getMin(), clip->getMax());
+            }
+            else
+                continue;
+            absorbConsumer(matmul, consumer);
+            changed = true;
+        }
+        compact();
+        return changed;
+    }
 
-                // 步骤1：判断Transpose的输出是MatMul的哪个输入（A还是B）
-                bool is_input_a = (succ_op->getInputs()[0] == trans_output);
-                bool is_input_b = (succ_op->getInputs()[1] == trans_output);
-                if (!is_input_a && !is_input_b)
-                {
-                    continue; // 理论上不可能，保险校验
-                }
+    static bool isFusable(const Operator &op)
+    {
+        switch (op->getOpType().underlying())
+        {
+        case OpType::Add:
+        case OpType::Sub:
+        case OpType::Mul:
+        case OpType::Div:
+        case OpType::Relu:
+        case OpType::Clip:
+            return true;
+        case OpType::Cast:
+            // The fused kernel computes in a single data type.
+            return op->getDType() == op->getOutDType();
+        default:
+            return false;
+        }
+    }
 
-                // 步骤2：断开Transpose与MatMul的依赖
-                curr_op->removeSuccessors(succ_op);
-                succ_op->removePredecessors(curr_op);
-                trans_output->removeTarget(succ_op); // 移除MatMul对trans_output的引用
+    bool GraphObj::fuseElementWise()
+    {
+        IT_ASSERT(topo_sort(), "Graph is not topologically sorted");
+        std::unordered_set<OperatorObj *> absorbed;
+        bool changed = false;
 
-                // 步骤3：MatMul直接使用Transpose的输入（跳过Transpose）
-                succ_op->replaceInput(trans_output, trans_input);
-                trans_input->addTarget(succ_op); // trans_input新增消费者MatMul
+        // Consumers are visited before producers, so every tree is rooted at
+        // the last operator of its chain.
+        const OpVec order = getOperators();
+        for (auto it = order.rbegin(); it != order.rend(); ++it)
+        {
+            const auto &root = *it;
+            if (absorbed.count(root.get()) || !isFusable(root))
+                continue;
+            const auto output = root->getOutput();
 
-                // 步骤4：更新MatMul的转置属性（合并Transpose的逻辑）
-                if (is_input_a)
+            // Walks the tree in postfix order with an explicit stack, so long
+            // chains cannot overflow the call stack. A producer is only
+            // absorbed while the kernel limits hold even if all of its
+            // inputs, and every input still pending, end up as new leaves;
+            // otherwise its output becomes a leaf and the tree is cut there.
+            struct Frame
+            {
+                Operator op;
+                size_t next;
+            };
+            TensorVec leaves;
+            OpVec tree{root};
+            vector<FusedStep> program;
+            vector<Frame> stack{{root, 0}};
+            int depth = 0, pending = root->getInputs().size();
+            while (!stack.empty())
+            {
+                const auto op = stack.back().op;
+                const auto &inputs = op->getInputs();
+                if (stack.back().next < inputs.size())
                 {
-                    matmul_op->setTransA(matmul_op->getTransA() ^ true); // 异或实现转置叠加
+                    const auto &input = inputs[stack.back().next++];
+                    --pending;
+                    auto source = input->getSource();
+                    if (source && isFusable(source) &&
+                        !absorbed.count(source.get()) &&
+                        input->getTargets().size() == 1 &&
+                        input->getDims() == output->getDims() &&
+                        input->getDType() == output->getDType())
+                    {
+                        int arity = source->getInputs().size();
+                        if (depth + arity <=
+                                FusedElementWiseObj::MaxStackDepth &&
+                            (int)leaves.size() + pending + arity <=
+                                FusedElementWiseObj::MaxInputs)
+                        {
+                            tree.emplace_back(source);
+                            stack.push_back({source, 0});
+                            pending += arity;
+                            continue;
+                        }
+                    }
+                    auto leaf = std::find(leaves.begin(), leaves.end(), input);
+                    FusedStep step{};
+                    step.input = leaf - leaves.begin();
+                    if (leaf == leaves.end())
+                        leaves.emplace_back(input);
+                    program.emplace_back(step);
+                    ++depth;
+                    continue;
                 }
-                else
+                stack.pop_back();
+                depth -= inputs.size() - 1;
+                if (op->getOpType() == OpType::Cast)
+                    continue;
+                FusedStep step{};
+                step.opType = op->getOpType().underlying();
+                step.input = -1;
+                if (op->getOpType() == OpType::Clip)
                 {
-                    matmul_op->setTransB(matmul_op->getTransB() ^ true);
+                    auto clip = as<ClipObj>(op);
+                    step.hasMin = clip->getMin().has_value();
+                    step.hasMax = clip->getMax().has_value();
+                    step.min = clip->getMin().value_or(0.f);
+                    step.max = clip->getMax().value_or(0.f);
                 }
+                program.emplace_back(step);
+            }
+            if (tree.size() < 2)
+                continue;
 
-                // 步骤5：标记待删除对象（若Transpose的输出无其他消费者）
-                if (trans_output->getTargets().empty())
-                {
-                    wait_for_cut.push_back(trans_output);
-                }
+            for (const auto &op : tree)
+            {
+                absorbed.insert(op.get());
+                detachOperator(op);
+                if (op != root)
+                    removeTensorLazily(op->getOutput());
             }
+            addOpWithOutputs<FusedElementWiseObj>(leaves, output, program);
+            changed = true;
         }
+        compact();
+        return changed;
+    }
+
+    // Floats per vector register of the host.
+    static int simdBlock()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        if (__builtin_cpu_supports("avx512f"))
+            return 16;
+#endif
+        return 8;
+    }
 
-        // -------------------------- 递归清理无效节点 --------------------------
-        while (!wait_for_cut.empty())
+    // Copies the constant B operand of a matmul into `packed`, a [K, N]
+    // constant with a blocked layout, transposing it if `transB`.
+    static void packConstant(const Tensor &B, bool transB,
+                             const Tensor &packed)
+    {
+        const auto dims = packed->getDims();
+        const size_t k = dims[0], n = dims[1], block = packed->getBlock();
+        const size_t bytes = B->getDType().getSize();
+        auto src = B->getRawDataPtr<const char *>();
+        auto dst = packed->getRawDataPtr<char *>();
+        for (size_t p = 0; p < k; ++p)
+            for (size_t j = 0; j < n; ++j)
+                std::memcpy(dst + (((j / block) * k + p) * block + j % block) *
+                                      bytes,
+                            src + (transB ? j * k + p : p * n + j) * bytes,
+                            bytes);
+    }
+
+    bool GraphObj::chooseLayouts(int block)
+    {
+        IT_ASSERT(topo_sort(), "Graph is not topologically sorted");
+        if (block == 0)
+            block = simdBlock();
+        // The packed matmul kernel only has micro-kernels for these widths.
+        IT_ASSERT(block == 8 || block == 16, "Unsupported layout block");
+        // Blocked copies of plain tensors, shared by all matmuls that read
+        // the same tensor the same way.
+        std::map<std::pair<Tensor, bool>, Tensor> packed;
+        bool changed = false;
+        const OpVec order = getOperators();
+        for (const auto &op : order)
         {
-            auto tensor = wait_for_cut.back();
-            wait_for_cut.pop_back();
+            if (op->getOpType() != OpType::MatMul)
+                continue;
+            auto matmul = as<MatmulObj>(op);
+            auto A = matmul->getInputs(0), B = matmul->getInputs(1);
+            bool transB = matmul->getTransB();
+            auto dtype = B->getDType();
+            // An empty operand or output leaves nothing to pack or run.
+            if (A == B || B->isBlocked() || B->getRank() != 2 ||
+                !(dtype == DataType::Float32 || dtype == DataType::UInt32) ||
+                B->size() == 0 || matmul->getOutput()->size() == 0)
+                continue;
 
-            if (auto prod_op = tensor->getSource())
-            { // 张量的生产者算子
-                // 断开生产者与前驱的连接
-                for (auto const &pred : prod_op->getPredecessors())
-                {
-                    pred->removeSuccessors(prod_op);
-                    prod_op->removePredecessors(pred);
-                }
-                // 断开生产者与输入张量的连接
-                for (auto const &input : prod_op->getInputs())
+            auto &blocked = packed[{B, transB}];
+            if (!blocked && B->isConstant())
+            {
+                // Packed once here, so the constant costs nothing at run
+                // time.
+                blocked = addTensor({matmul->getK(), matmul->getN()}, dtype);
+                blocked->setBlock(block);
+                blocked->setConstant();
+                packConstant(B, transB, blocked);
+            }
+            else if (!blocked)
+            {
+                // A Reorder runs every time, so it has to pay off over the
+                // rows of the output, and it does not transpose.
+                size_t rows = matmul->getOutput()->size() / matmul->getN();
+                if (transB || rows < (size_t)block)
                 {
-                    input->removeTarget(prod_op);
-                    if (input->getTargets().empty())
-                    {
-                        wait_for_cut.push_back(input);
-                    }
+                    packed.erase({B, transB});
+                    continue;
                 }
-                // 标记删除
-                remove_ops.push_back(prod_op);
-                remove_tensors.push_back(tensor);
+                blocked = addOp<ReorderObj>(B, nullptr, block)->getOutput();
             }
+            redirectInput(matmul, B, blocked);
+            matmul->setTransB(false);
+            if (B->isConstant() && B->getNumTargets() == 0 && !B->getSource())
+                removeTensorLazily(B);
+            changed = true;
         }
-        for (auto const &op : remove_ops)
-        {
-            ops.erase(std::remove(ops.begin(), ops.end(), op), ops.end());
-        }
-        for (auto const &tensor : remove_tensors)
-        {
-            tensors.erase(std::remove(tensors.begin(), tensors.end(), tensor), tensors.end());
-        }
+        compact();
+        return changed;
     }
 
     Tensor GraphObj::getTensor(int fuid) const
     {
-        for (auto tensor : tensors)
+        auto it = fuidIndex.find(fuid);
+        return it == fuidIndex.end() ? nullptr : it->second;
+    }
+
+    void GraphObj::setShape(const Tensor &tensor, const Shape &shape)
+    {
+        IT_ASSERT(hasTensor(tensor));
+        if (shape == tensor->getDims())
+            return;
+        // An input that changes byte size needs a new arena even if no
+        // output does.
+        if (tensor->getBytes() !=
+            tensor->getDType().getSize() *
+                std::accumulate(shape.begin(), shape.end(), size_t(1),
+                                std::multiplies<size_t>()))
+            resizedInputs = true;
+        tensor->setShape(shape);
+        invalidatePlan();
+        for (const auto &op : tensor->getTargets())
+            dirtyOps.emplace_back(op);
+    }
+
+    bool GraphObj::inferOutputShapes(const Operator &op, bool &resized)
+    {
+        auto ans = op->inferShape();
+        IT_ASSERT(ans.has_value());
+        const auto &outputs = op->getOutputs();
+        IT_ASSERT(ans.value().size() == outputs.size());
+        bool changed = false;
+        for (size_t i = 0; i < outputs.size(); ++i)
         {
-            if (tensor->getFuid() == fuid)
-            {
-                return tensor;
-            }
+            const auto &newShape = ans.value()[i];
+            if (newShape == outputs[i]->getDims())
+                continue;
+            auto bytes = outputs[i]->getBytes();
+            bool view = outputs[i]->isView();
+            outputs[i]->setShape(newShape);
+            resized |= view || bytes != outputs[i]->getBytes();
+            changed = true;
         }
-        return nullptr;
+        return changed;
     }
 
     void GraphObj::shape_infer()
     {
-        for (auto &op : ops)
+        IT_ASSERT(topo_sort());
+        bool changed = false, resized = resizedInputs;
+        if (dirtyOps.empty())
         {
-            auto ans = op->inferShape();
-            IT_ASSERT(ans.has_value());
-            auto oldOutputs = op->getOutputs();
-            IT_ASSERT(ans.value().size() == oldOutputs.size());
-            // replace the old outputshape and size with new one
-            for (int i = 0; i < (int)ans.value().size(); ++i)
+            // Inputs reshaped directly on the tensor invalidate the plan and
+            // the arena even if no output shape changes, e.g. under
+            // broadcasting.
+            for (const auto &tensor : getTensors())
             {
-                auto newShape = ans.value()[i];
-                auto oldShape = oldOutputs[i]->getDims();
-                auto fuid = oldOutputs[i]->getFuid();
-                if (newShape != oldShape)
-                {
-                    auto tensor = this->getTensor(fuid);
-                    tensor->setShape(newShape);
-                }
+                auto it = inputShapes.find(tensor.get());
+                if (tensor->getSource() || it == inputShapes.end() ||
+                    it->second.first == tensor->getDims())
+                    continue;
+                changed = true;
+                resized |= it->second.second != tensor->getBytes();
+            }
+            for (const auto &op : getOperators())
+                changed |= inferOutputShapes(op, resized);
+        }
+        else
+        {
+            // Visit the downstream cone in topological order, so every op is
+            // inferred once, after all its producers.
+            auto later = [this](const Operator &a, const Operator &b)
+            { return opOrder.at(a.get()) > opOrder.at(b.get()); };
+            std::priority_queue<Operator, OpVec, decltype(later)> queue(
+                later);
+            std::unordered_set<const OperatorObj *> queued;
+            for (const auto &op : dirtyOps)
+                if (hasOperator(op) && queued.insert(op.get()).second)
+                    queue.push(op);
+            dirtyOps.clear();
+            while (!queue.empty())
+            {
+                auto op = queue.top();
+                queue.pop();
+                if (!inferOutputShapes(op, resized))
+                    continue;
+                changed = true;
+                for (const auto &output : op->getOutputs())
+                    for (const auto &target : output->getTargets())
+                        if (queued.insert(target.get()).second)
+                            queue.push(target);
             }
         }
+        resizedInputs = false;
+        if (changed)
+            invalidatePlan();
+        if (resized && allocated)
+            dataMalloc();
+        else
+            recordInputShapes();
+    }
+
+    void GraphObj::recordInputShapes()
+    {
+        inputShapes.clear();
+        for (const auto &tensor : getTensors())
+            if (!tensor->getSource())
+                inputShapes.emplace(
+                    tensor.get(),
+                    std::make_pair(tensor->getDims(), tensor->getBytes()));
     }
 
     void GraphObj::dataMalloc()
     {
         // topological sorting first
         IT_ASSERT(topo_sort() == true);
+        invalidatePlan();
 
         // =================================== 作业 ===================================
         // TODO：利用 allocator 给计算图分配内存
         // HINT: 获取分配好的内存指针后，可以调用 tensor 的 setDataBlob 函数给 tensor 绑定内存
         // =================================== 作业 ===================================
-        std::vector<size_t> offsets;
-        // Add all the tensors to the allocator
+        allocator.reset();
+        allocated = true;
+        const auto &tensors = getTensors();
+        std::unordered_set<const TensorObj *> viewed;
+        const auto views = planViews(viewed);
+        auto &offsets = memoryPlan.offsets;
+        offsets.clear();
+        // Add all the tensors to the allocator. Constants own their data,
+        // external tensors use the caller's memory and views share the data
+        // of their inputs.
+        auto inArena = [&](const Tensor &tensor)
+        {
+            return !tensor->isConstant() && !tensor->isExternal() &&
+                   !viewed.count(tensor.get());
+        };
         for (const auto &tensor : tensors)
         {
-            offsets.push_back(allocator.alloc(tensor->getBytes()));
+            offsets.push_back(
+                inArena(tensor) ? allocator.alloc(tensor->getBytes()) : 0);
         }
+        memoryPlan.size = allocator.getPeak();
+        recordInputShapes();
 
         const auto base = reinterpret_cast<char *>(allocator.getPtr());
 
         for (size_t i = 0; i < tensors.size(); ++i)
         {
             auto tensor = tensors[i];
-            tensor->setDataBlob(make_ref<BlobObj>(runtime, base + offsets[i]));
+            if (inArena(tensor))
+                tensor->setDataBlob(
+                    make_ref<BlobObj>(runtime, base + offsets[i]));
         }
+        bindViews(views);
 
         allocator.info();
     }
 
+    void GraphObj::dataMalloc(const MemoryPlan &plan)
+    {
+        IT_ASSERT(topo_sort() == true);
+        invalidatePlan();
+        const auto &tensors = getTensors();
+        IT_ASSERT(plan.offsets.size() == tensors.size(),
+                  "Memory plan does not match the graph");
+        allocator.reset();
+        allocated = true;
+        std::unordered_set<const TensorObj *> viewed;
+        const auto views = planViews(viewed);
+        auto arena = make_ref<BlobObj>(runtime, std::max<size_t>(plan.size, 1));
+        const auto base = arena->getPtr<char *>();
+        for (size_t i = 0; i < tensors.size(); ++i)
+        {
+            const auto &tensor = tensors[i];
+            if (tensor->isConstant() || tensor->isExternal() ||
+                viewed.count(tensor.get()))
+                continue;
+            IT_ASSERT(plan.offsets[i] + tensor->getBytes() <= plan.size,
+                      "Memory plan does not match the graph");
+            // Each view keeps the arena alive.
+            tensor->setDataBlob(
+                make_ref<BlobObj>(runtime, base + plan.offsets[i], arena));
+        }
+        bindViews(views);
+        memoryPlan = plan;
+        recordInputShapes();
+    }
+
+    OpVec GraphObj::planViews(
+        std::unordered_set<const TensorObj *> &outputs)
+    {
+        const auto &registry = KernelRegistry::getInstance();
+        const auto device = runtime->getDevice();
+        OpVec views;
+        for (const auto &op : getOperators())
+        {
+            if (op->numInputs() != 1 || op->numOutputs() != 1)
+                continue;
+            const auto &input = op->getInputs(0), &output = op->getOutput();
+            // A view would keep the first address bound to an external input.
+            if (output->getRank() == 0 || input->isBlocked() ||
+                input->isExternal() || !op->getViewStrides(input->getStrides()))
+                continue;
+            // Graph outputs stay dense for the caller to read.
+            const auto targets = output->getTargets();
+            bool strided = !targets.empty();
+            for (const auto &target : targets)
+                strided &= registry.supportsStridedInputs(
+                    {device, target->getOpType().underlying()});
+            if (!strided)
+                continue;
+            views.emplace_back(op);
+            outputs.insert(output.get());
+        }
+        return views;
+    }
+
+    void GraphObj::bindViews(const OpVec &views) const
+    {
+        // In topological order, so the input of a view of a view is bound
+        // before it is viewed and the strides compose.
+        for (const auto &op : views)
+        {
+            const auto &input = op->getInputs(0);
+            op->getOutput()->setView(
+                input, op->getViewStrides(input->getStrides()).value());
+        }
+    }
+
+    void GraphObj::bindExternal(const Tensor &tensor, void *data)
+    {
+        IT_ASSERT(hasTensor(tensor), "Tensor is not in the graph");
+        IT_ASSERT(!tensor->isConstant() && !tensor->isBlocked() &&
+                      !tensor->isView(),
+                  "Only dense non-constant tensors can be bound externally");
+        IT_ASSERT(!tensor->getSource() || tensor->getTargets().empty(),
+                  "Only graph inputs and outputs can be bound externally");
+        IT_ASSERT(data != nullptr &&
+                      reinterpret_cast<uintptr_t>(data) %
+                              tensor->getDType().getSize() ==
+                          0,
+                  "External buffer is null or misaligned");
+        tensor->setDataBlob(make_ref<BlobObj>(runtime, data));
+        if (tensor->external)
+        {
+            if (capturedPlan)
+                capturedPlan->updateExternals();
+            return;
+        }
+        tensor->external = true;
+        // Take the tensor out of the arena.
+        if (allocated)
+            dataMalloc();
+    }
+
+    void GraphObj::unbindExternal(const Tensor &tensor)
+    {
+        IT_ASSERT(hasTensor(tensor), "Tensor is not in the graph");
+        if (!tensor->external)
+            return;
+        tensor->external = false;
+        tensor->setDataBlob(nullptr);
+        if (allocated)
+            dataMalloc();
+    }
+
+    ExecutionPlan GraphObj::compile()
+    {
+        IT_ASSERT(topo_sort() == true);
+        return make_ref<ExecutionPlanObj>(*this);
+    }
+
+    ExecutionPlan GraphObj::compile(const vector<string> &kernels)
+    {
+        IT_ASSERT(topo_sort() == true);
+        return make_ref<ExecutionPlanObj>(*this, &kernels);
+    }
+
+    ExecutionPlan GraphObj::getCapturedPlan()
+    {
+        if (!capturedPlan)
+            capturedPlan = compile();
+        return capturedPlan;
+    }
+
     Tensor GraphObj::addTensor(Shape dim, DataType dtype)
     {
-        return tensors.emplace_back(make_ref<TensorObj>(dim, dtype, runtime));
+        return addTensor(make_ref<TensorObj>(dim, dtype, runtime));
     }
 
     Tensor GraphObj::addTensor(const Tensor &tensor)
@@ -407,7 +1123,12 @@ namespace infini
                   std::string("Tensor runtime mismatch: cannot add a tenosr in ") +
                       tensor->getRuntime()->toString() + " to " +
                       runtime->toString());
-        tensors.emplace_back(tensor);
+        if (tensorIndex.insert(tensor.get()).second)
+        {
+            if (!removedTensors.erase(tensor.get()))
+                tensors.emplace_back(tensor);
+            fuidIndex[tensor->getFuid()] = tensor;
+        }
         return tensor;
     }
 
@@ -418,53 +1139,105 @@ namespace infini
         return tensors;
     }
 
+    int64_t GraphObj::getFlops() const
+    {
+        int64_t flops = 0;
+        for (const auto &op : getOperators())
+            flops += op->getFlops();
+        return flops;
+    }
+
+    int64_t GraphObj::getBytesMoved() const
+    {
+        int64_t bytes = 0;
+        for (const auto &op : getOperators())
+            bytes += op->getBytesRead() + op->getBytesWritten();
+        return bytes;
+    }
+
+    string GraphObj::rooflineReport(double peakGflops, double peakGBps) const
+    {
+        IT_ASSERT(peakGflops > 0 && peakGBps > 0);
+        // GFLOP/s and GB/s are FLOPs and bytes per nanosecond.
+        const double ridge = peakGflops / peakGBps;
+        std::ostringstream oss;
+        auto row = [&](const string &guid, const string &name, int64_t flops,
+                       int64_t bytes, double us)
+        {
+            double intensity = bytes ? (double)flops / bytes : 0;
+            oss << std::left << std::setw(8) << guid << std::setw(20) << name
+                << std::right << std::setw(14) << flops << std::setw(14)
+                << bytes << std::setw(10) << intensity << std::setw(9)
+                << (intensity >= ridge ? "compute" : "memory") << std::setw(10)
+                << std::min(peakGflops, intensity * peakGBps) << std::setw(12)
+                << us << "\n";
+        };
+        oss << std::left << std::setw(8) << "Guid" << std::setw(20) << "Op"
+            << std::right << std::setw(14) << "FLOPs" << std::setw(14)
+            << "Bytes" << std::setw(10) << "FLOP/B" << std::setw(9)
+            << "Bound" << std::setw(10) << "GFLOP/s" << std::setw(12)
+            << "Time(us)" << "\n";
+        oss << std::fixed << std::setprecision(3);
+        double total = 0;
+        for (const auto &op : getOperators())
+        {
+            int64_t flops = op->getFlops();
+            int64_t bytes = op->getBytesRead() + op->getBytesWritten();
+            double us = std::max(flops / peakGflops, bytes / peakGBps) / 1e3;
+            total += us;
+            row(std::to_string(op->getGuid()), op->getOpType().toString(),
+                flops, bytes, us);
+        }
+        row("", "Total", getFlops(), getBytesMoved(), total);
+        oss << "Ridge point: " << ridge << " FLOP/B\n";
+        return oss.str();
+    }
+
     // tensor's "source" and "target" must be in "ops".
     // tensor has no "source" and no "target" must not exist.
     // "inputs" or "outputs" of operators must be in "tensors"
     // "predecessors" and "successors" of an operator of "ops" must be in "ops".
     bool GraphObj::checkValid() const
     {
+        const auto &tensors = getTensors();
         for (auto tensor : tensors)
         {
-            IT_ASSERT(!(tensor->getTargets().size() == 0 &&
+            IT_ASSERT(!(tensor->getNumTargets() == 0 &&
                         nullptr == tensor->getSource()));
             for (auto op : tensor->getTargets())
             {
-                IT_ASSERT(std::find(ops.begin(), ops.end(), op) != ops.end());
+                IT_ASSERT(hasOperator(op));
             }
             auto op = tensor->getSource();
-            IT_ASSERT(!(op && std::find(ops.begin(), ops.end(), op) == ops.end()));
+            IT_ASSERT(!(op && !hasOperator(op)));
         }
-        for (auto op : ops)
+        for (auto op : getOperators())
         {
             for (auto tensor : op->getInputs())
             {
-                IT_ASSERT(std::find(tensors.begin(), tensors.end(), tensor) !=
-                          tensors.end());
+                IT_ASSERT(hasTensor(tensor));
             }
             for (auto tensor : op->getOutputs())
             {
-                IT_ASSERT(std::find(tensors.begin(), tensors.end(), tensor) !=
-                          tensors.end());
+                IT_ASSERT(hasTensor(tensor));
             }
             for (auto pre : op->getPredecessors())
             {
-                IT_ASSERT(std::find(ops.begin(), ops.end(), pre) != ops.end());
+                IT_ASSERT(hasOperator(pre));
             }
             for (auto suc : op->getSuccessors())
             {
-                IT_ASSERT(std::find(ops.begin(), ops.end(), suc) != ops.end());
+                IT_ASSERT(hasOperator(suc));
             }
         }
-        std::set<UidBaseType> s;
+        std::unordered_set<UidBaseType> s;
         // check whether two tensors with the same FUID exist
         for (auto tensor : tensors)
         {
-            int cnt = s.count(tensor->getFuid());
-            IT_ASSERT(cnt == 0, std::to_string(tensor->getFuid()));
-            s.insert(tensor->getFuid());
+            IT_ASSERT(s.insert(tensor->getFuid()).second,
+                      std::to_string(tensor->getFuid()));
         }
         return true;
     }
 
-} // namespace infini
\ No newline at end of file
+} // namespace infini
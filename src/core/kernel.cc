@@ -0,0 +1,15 @@
+#include "core/kernel.h"
+#include "core/plan.h"
+
+namespace infini
+{
+    void CpuKernelWithoutConfig::compute(const Operator &op,
+                                         const RuntimeObj *context) const
+    {
+        vector<TensorDesc> descs;
+        OpRecord record;
+        lowerOperator(op, this, descs, record);
+        execute(record, context);
+    }
+
+} // namespace infini
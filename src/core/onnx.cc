@@ -0,0 +1,633 @@
+#include "core/onnx.h"
+#include "core/blob.h"
+#include "core/runtime.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include "utils/mapped_file.h"
+#include <cstring>
+#include <string_view>
+
+namespace infini
+{
+    namespace
+    {
+        /**
+         * @brief One field of a protobuf message. Varint and fixed-width
+         * values are kept in `value`; length-delimited ones refer to the
+         * bytes of the message they were read from.
+         */
+        struct Field
+        {
+            uint32_t number;
+            int wireType;
+            uint64_t value;
+            std::string_view bytes;
+        };
+
+        enum WireType
+        {
+            Varint = 0,
+            Fixed64 = 1,
+            LengthDelimited = 2,
+            Fixed32 = 5,
+        };
+
+        uint64_t readVarint(const uint8_t *&p, const uint8_t *end)
+        {
+            uint64_t ret = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                IT_ASSERT(p < end, "Truncated protobuf varint");
+                uint8_t byte = *p++;
+                ret |= uint64_t(byte & 0x7f) << shift;
+                if (!(byte & 0x80))
+                    return ret;
+            }
+            IT_ASSERT(false, "Malformed protobuf varint");
+            return 0;
+        }
+
+        /**
+         * @brief Iterates over the fields of a protobuf message in wire
+         * order without building any objects.
+         */
+        class ProtoReader
+        {
+            const uint8_t *p, *end;
+
+            uint64_t varint() { return readVarint(p, end); }
+
+            uint64_t fixed(size_t size)
+            {
+                IT_ASSERT((size_t)(end - p) >= size, "Truncated protobuf");
+                uint64_t ret = 0;
+                std::memcpy(&ret, p, size);
+                p += size;
+                return ret;
+            }
+
+        public:
+            explicit ProtoReader(std::string_view bytes)
+                : p(reinterpret_cast<const uint8_t *>(bytes.data())),
+                  end(p + bytes.size()) {}
+
+            bool next(Field &field)
+            {
+                if (p == end)
+                    return false;
+                uint64_t key = varint();
+                field.number = key >> 3;
+                field.wireType = key & 7;
+                switch (field.wireType)
+                {
+                case Varint:
+                    field.value = varint();
+                    break;
+                case Fixed64:
+                    field.value = fixed(8);
+                    break;
+                case Fixed32:
+                    field.value = fixed(4);
+                    break;
+                case LengthDelimited:
+                {
+                    uint64_t size = varint();
+                    IT_ASSERT(size <= (uint64_t)(end - p),
+                              "Truncated protobuf field");
+                    field.bytes = {reinterpret_cast<const char *>(p),
+                                   (size_t)size};
+                    p += size;
+                    break;
+                }
+                default:
+                    IT_TODO_HALT_MSG("Unsupported protobuf wire type " +
+                                     std::to_string(field.wireType));
+                }
+                return true;
+            }
+        };
+
+        // Repeated scalars may be packed into one length-delimited field.
+        void appendInts(const Field &field, vector<int64_t> &out)
+        {
+            if (field.wireType != LengthDelimited)
+            {
+                out.push_back((int64_t)field.value);
+                return;
+            }
+            auto p = reinterpret_cast<const uint8_t *>(field.bytes.data());
+            const auto end = p + field.bytes.size();
+            while (p < end)
+                out.push_back((int64_t)readVarint(p, end));
+        }
+
+        void appendFloats(const Field &field, vector<float> &out)
+        {
+            auto append = [&](const char *src, size_t n)
+            {
+                size_t old = out.size();
+                out.resize(old + n);
+                std::memcpy(out.data() + old, src, n * sizeof(float));
+            };
+            if (field.wireType == Fixed32)
+            {
+                uint32_t bits = field.value;
+                append(reinterpret_cast<const char *>(&bits), 1);
+            }
+            else
+            {
+                IT_ASSERT(field.bytes.size() % sizeof(float) == 0);
+                append(field.bytes.data(), field.bytes.size() / sizeof(float));
+            }
+        }
+
+        // onnx.TensorProto
+        struct TensorProto
+        {
+            std::string_view name, raw;
+            vector<int64_t> dims, int64Data, int32Data;
+            vector<float> floatData;
+            int dataType = 0;
+            bool external = false;
+
+            explicit TensorProto(std::string_view bytes)
+            {
+                ProtoReader reader(bytes);
+                Field f;
+                while (reader.next(f))
+                {
+                    switch (f.number)
+                    {
+                    case 1:
+                        appendInts(f, dims);
+                        break;
+                    case 2:
+                        dataType = f.value;
+                        break;
+                    case 4:
+                        appendFloats(f, floatData);
+                        break;
+                    case 5:
+                        appendInts(f, int32Data);
+                        break;
+                    case 7:
+                        appendInts(f, int64Data);
+                        break;
+                    case 8:
+                        name = f.bytes;
+                        break;
+                    case 9:
+                        raw = f.bytes;
+                        break;
+                    case 14:
+                        external = f.value == 1;
+                        break;
+                    }
+                }
+            }
+        };
+
+        // onnx.AttributeProto
+        struct Attribute
+        {
+            float f = 0;
+            int64_t i = 0;
+            std::string_view s, t;
+            vector<int64_t> ints;
+        };
+
+        // onnx.NodeProto
+        struct NodeProto
+        {
+            vector<std::string_view> inputs, outputs;
+            std::string_view opType;
+            std::map<std::string_view, Attribute> attrs;
+
+            explicit NodeProto(std::string_view bytes)
+            {
+                ProtoReader reader(bytes);
+                Field f;
+                while (reader.next(f))
+                {
+                    if (f.number == 1)
+                        inputs.push_back(f.bytes);
+                    else if (f.number == 2)
+                        outputs.push_back(f.bytes);
+                    else if (f.number == 4)
+                        opType = f.bytes;
+                    else if (f.number == 5)
+                        addAttribute(f.bytes);
+                }
+            }
+
+            void addAttribute(std::string_view bytes)
+            {
+                ProtoReader reader(bytes);
+                Field f;
+                std::string_view name;
+                Attribute attr;
+                while (reader.next(f))
+                {
+                    switch (f.number)
+                    {
+                    case 1:
+                        name = f.bytes;
+                        break;
+                    case 2:
+                    {
+                        uint32_t bits = f.value;
+                        std::memcpy(&attr.f, &bits, sizeof(float));
+                        break;
+                    }
+                    case 3:
+                        attr.i = (int64_t)f.value;
+                        break;
+                    case 4:
+                        attr.s = f.bytes;
+                        break;
+                    case 5:
+                        attr.t = f.bytes;
+                        break;
+                    case 8:
+                        appendInts(f, attr.ints);
+                        break;
+                    }
+                }
+                attrs.emplace(name, attr);
+            }
+
+            const Attribute *attr(std::string_view name) const
+            {
+                auto it = attrs.find(name);
+                return it == attrs.end() ? nullptr : &it->second;
+            }
+            // An empty name marks an omitted optional input.
+            bool hasInput(size_t i) const
+            {
+                return i < inputs.size() && !inputs[i].empty();
+            }
+        };
+
+        /**
+         * @brief Name and shape of an onnx.ValueInfoProto.
+         */
+        struct ValueInfo
+        {
+            std::string_view name;
+            int elemType = 0;
+            Shape shape;
+
+            ValueInfo(std::string_view bytes,
+                      const std::map<string, int> &dimParams)
+            {
+                ProtoReader reader(bytes);
+                Field f;
+                while (reader.next(f))
+                {
+                    if (f.number == 1)
+                        name = f.bytes;
+                    else if (f.number == 2)
+                        parseType(f.bytes, dimParams);
+                }
+            }
+
+            void parseType(std::string_view bytes,
+                           const std::map<string, int> &dimParams)
+            {
+                Field f, g, d;
+                // TypeProto.tensor_type
+                for (ProtoReader type(bytes); type.next(f);)
+                {
+                    if (f.number != 1)
+                        continue;
+                    for (ProtoReader tensor(f.bytes); tensor.next(g);)
+                    {
+                        if (g.number == 1)
+                            elemType = g.value;
+                        if (g.number != 2)
+                            continue;
+                        // TensorShapeProto.dim
+                        for (ProtoReader shapeReader(g.bytes);
+                             shapeReader.next(d);)
+                        {
+                            if (d.number == 1)
+                                shape.push_back(parseDim(d.bytes, dimParams));
+                        }
+                    }
+                }
+            }
+
+            int parseDim(std::string_view bytes,
+                         const std::map<string, int> &dimParams) const
+            {
+                Field f;
+                for (ProtoReader dim(bytes); dim.next(f);)
+                {
+                    if (f.number == 1)
+                        return f.value;
+                    if (f.number == 2)
+                    {
+                        auto it = dimParams.find(string(f.bytes));
+                        IT_ASSERT(it != dimParams.end(),
+                                  "No value for dimension " + string(f.bytes) +
+                                      " of " + string(name));
+                        return it->second;
+                    }
+                }
+                IT_ASSERT(false, "Unknown dimension of " + string(name));
+                return 0;
+            }
+        };
+
+        CastType castType(DataType from, DataType to)
+        {
+            static const std::tuple<int, int, CastType> table[] = {
+                {1, 10, CastType::Float2Float16},
+                {1, 7, CastType::Float2Int64},
+                {1, 6, CastType::Float2Int32},
+                {1, 5, CastType::Float2Int16},
+                {1, 3, CastType::Float2Int8},
+                {1, 16, CastType::Float2BFloat16},
+                {6, 1, CastType::Int322Float},
+                {6, 3, CastType::Int322Int8},
+                {6, 5, CastType::Int322Int16},
+                {6, 7, CastType::Int322Int64},
+                {5, 1, CastType::Int162Float},
+                {5, 6, CastType::Int162Int32},
+                {3, 1, CastType::Int82Float},
+                {3, 5, CastType::Int82Int16},
+                {3, 6, CastType::Int82Int32},
+                {2, 1, CastType::Uint82Float},
+                {2, 6, CastType::Uint82Int32},
+                {2, 7, CastType::Uint82Int64},
+                {7, 6, CastType::Int642Int32},
+                {7, 12, CastType::Int642Uint32},
+                {7, 1, CastType::Int642Float},
+                {12, 7, CastType::Uint322Int64},
+                {10, 1, CastType::Float162Float},
+                {16, 1, CastType::BFloat162Float},
+                {1, 1, CastType::Float2Float},
+            };
+            for (const auto &[f, t, type] : table)
+                if (from.getIndex() == f && to.getIndex() == t)
+                    return type;
+            IT_TODO_HALT_MSG("Unsupported Cast from " + from.toString() +
+                             " to " + to.toString());
+        }
+
+        class Importer
+        {
+            Runtime runtime;
+            std::shared_ptr<void> mapping;
+            OnnxModel model;
+
+            Tensor &lookup(std::string_view name)
+            {
+                auto it = model.tensors.find(string(name));
+                IT_ASSERT(it != model.tensors.end(),
+                          "Unknown ONNX value " + string(name));
+                return it->second;
+            }
+
+            float scalar(std::string_view name)
+            {
+                auto tensor = lookup(name);
+                IT_ASSERT(tensor->isConstant() && tensor->size() == 1 &&
+                              tensor->getDType() == DataType::Float32,
+                          string(name) + " must be a constant float scalar");
+                return *tensor->getRawDataPtr<float *>();
+            }
+
+        public:
+            Importer(Runtime runtime, std::shared_ptr<void> mapping)
+                : runtime(std::move(runtime)), mapping(std::move(mapping))
+            {
+                model.graph = make_ref<GraphObj>(this->runtime);
+            }
+
+            void addConstant(const TensorProto &proto)
+            {
+                IT_ASSERT(!proto.external,
+                          "External data of " + string(proto.name) +
+                              " is not supported");
+                DataType dtype(proto.dataType);
+                auto tensor = model.graph->addTensor(
+                    Shape(proto.dims.begin(), proto.dims.end()), dtype);
+                model.tensors[string(proto.name)] = tensor;
+                const size_t bytes = tensor->getBytes();
+                if (!proto.raw.empty())
+                {
+                    IT_ASSERT(proto.raw.size() == bytes,
+                              "Bad raw data of " + string(proto.name));
+                    auto ptr = const_cast<char *>(proto.raw.data());
+                    if ((uintptr_t)ptr % dtype.getSize() == 0)
+                        tensor->setConstant(
+                            make_ref<BlobObj>(runtime, ptr, mapping));
+                    else
+                        tensor->setConstant(ptr);
+                }
+                else if (dtype == DataType::Float32)
+                {
+                    IT_ASSERT(proto.floatData.size() == tensor->size());
+                    tensor->setConstant(proto.floatData.data());
+                }
+                else if (dtype == DataType::Int64 || dtype == DataType::Int32)
+                {
+                    const auto &src = dtype == DataType::Int64
+                                          ? proto.int64Data
+                                          : proto.int32Data;
+                    IT_ASSERT(src.size() == tensor->size());
+                    tensor->setConstant();
+                    for (size_t i = 0; i < src.size(); ++i)
+                        if (dtype == DataType::Int64)
+                            tensor->getRawDataPtr<int64_t *>()[i] = src[i];
+                        else
+                            tensor->getRawDataPtr<int32_t *>()[i] = src[i];
+                }
+                else
+                    IT_TODO_HALT_MSG("Unsupported data of " +
+                                     string(proto.name));
+            }
+
+            void addInput(const ValueInfo &info)
+            {
+                // Older models also list initializers as inputs.
+                if (model.tensors.count(string(info.name)))
+                    return;
+                auto tensor =
+                    model.graph->addTensor(info.shape, DataType(info.elemType));
+                model.tensors[string(info.name)] = tensor;
+                model.inputs.emplace_back(tensor);
+            }
+
+            void addOutput(const ValueInfo &info)
+            {
+                model.outputs.emplace_back(lookup(info.name));
+            }
+
+            void addNode(const NodeProto &node)
+            {
+                auto &g = model.graph;
+                const auto &type = node.opType;
+                TensorVec in;
+                for (size_t i = 0; i < node.inputs.size(); ++i)
+                    in.emplace_back(node.hasInput(i) ? lookup(node.inputs[i])
+                                                     : nullptr);
+                Operator op;
+                if (type == "Add")
+                    op = g->addOp<AddObj>(in[0], in[1], nullptr);
+                else if (type == "Sub")
+                    op = g->addOp<SubObj>(in[0], in[1], nullptr);
+                else if (type == "Mul")
+                    op = g->addOp<MulObj>(in[0], in[1], nullptr);
+                else if (type == "Div")
+                    op = g->addOp<DivObj>(in[0], in[1], nullptr);
+                else if (type == "Relu")
+                    op = g->addOp<ReluObj>(in[0], nullptr);
+                else if (type == "Clip")
+                {
+                    // Bounds are attributes before opset 11 and inputs after.
+                    std::optional<float> min, max;
+                    if (auto a = node.attr("min"))
+                        min = a->f;
+                    if (auto a = node.attr("max"))
+                        max = a->f;
+                    if (node.hasInput(1))
+                        min = scalar(node.inputs[1]);
+                    if (node.hasInput(2))
+                        max = scalar(node.inputs[2]);
+                    op = g->addOp<ClipObj>(in[0], nullptr, min, max);
+                }
+                else if (type == "Cast")
+                {
+                    auto to = node.attr("to");
+                    IT_ASSERT(to, "Cast without a target type");
+                    op = g->addOp<CastObj>(
+                        in[0], nullptr,
+                        castType(in[0]->getDType(), DataType(to->i)));
+                }
+                else if (type == "MatMul")
+                    op = g->addOp<MatmulObj>(in[0], in[1], nullptr);
+                else if (type == "Gemm")
+                    op = addGemm(node, in);
+                else if (type == "Transpose")
+                {
+                    Shape perm;
+                    if (auto a = node.attr("perm"))
+                        perm.assign(a->ints.begin(), a->ints.end());
+                    else
+                        for (int i = in[0]->getRank() - 1; i >= 0; --i)
+                            perm.push_back(i);
+                    op = g->addOp<TransposeObj>(in[0], nullptr, perm);
+                }
+                else if (type == "Concat")
+                {
+                    auto axis = node.attr("axis");
+                    IT_ASSERT(axis, "Concat without an axis");
+                    int dim = axis->i < 0 ? axis->i + in[0]->getRank()
+                                          : axis->i;
+                    op = g->addOp<ConcatObj>(in, nullptr, dim);
+                }
+                else if (type == "Constant")
+                {
+                    auto value = node.attr("value");
+                    IT_ASSERT(value && !value->t.empty(),
+                              "Only tensor Constants are supported");
+                    TensorProto proto(value->t);
+                    proto.name = node.outputs[0];
+                    addConstant(proto);
+                    return;
+                }
+                else
+                    IT_TODO_HALT_MSG("Unsupported ONNX operator " +
+                                     string(type));
+
+                IT_ASSERT(node.outputs.size() == op->getOutputs().size());
+                for (size_t i = 0; i < node.outputs.size(); ++i)
+                    model.tensors[string(node.outputs[i])] = op->getOutput(i);
+            }
+
+            Operator addGemm(const NodeProto &node, const TensorVec &in)
+            {
+                for (auto name : {"alpha", "beta"})
+                    if (auto a = node.attr(name))
+                        IT_ASSERT(a->f == 1.f, "Gemm with a " + string(name) +
+                                                   " other than 1");
+                bool transA = node.attr("transA") && node.attr("transA")->i;
+                bool transB = node.attr("transB") && node.attr("transB")->i;
+                Tensor bias = in.size() > 2 ? in[2] : nullptr;
+                // The epilogue only adds a bias that broadcasts along rows.
+                int n = in[1]->getDims()[transB ? 0 : 1];
+                if (bias && bias->size() != 1 &&
+                    !(bias->getDims().back() == n && (int)bias->size() == n))
+                {
+                    auto mm = model.graph->addOp<MatmulObj>(
+                        in[0], in[1], nullptr, transA, transB);
+                    return model.graph->addOp<AddObj>(mm->getOutput(), bias,
+                                                      nullptr);
+                }
+                return model.graph->addOp<MatmulObj>(in[0], in[1], nullptr,
+                                                     transA, transB, bias);
+            }
+
+            OnnxModel finish()
+            {
+                // Constants only read as attributes, e.g. Clip bounds, are
+                // not part of the graph.
+                for (auto it = model.tensors.begin();
+                     it != model.tensors.end();)
+                {
+                    const auto &tensor = it->second;
+                    if (tensor->isConstant() && tensor->getNumTargets() == 0 &&
+                        std::find(model.outputs.begin(), model.outputs.end(),
+                                  tensor) == model.outputs.end())
+                    {
+                        model.graph->removeTensor(tensor);
+                        it = model.tensors.erase(it);
+                    }
+                    else
+                        ++it;
+                }
+                return std::move(model);
+            }
+        };
+    } // namespace
+
+    OnnxModel importOnnx(Runtime runtime, const string &path,
+                         const std::map<string, int> &dimParams)
+    {
+        size_t size;
+        auto mapping = mapFile(path, size);
+        std::string_view file(static_cast<const char *>(mapping.get()), size);
+        Importer importer(runtime, mapping);
+
+        // ModelProto.graph
+        std::string_view graph;
+        Field f;
+        for (ProtoReader model(file); model.next(f);)
+            if (f.number == 7)
+                graph = f.bytes;
+        IT_ASSERT(!graph.empty(), path + " has no graph");
+
+        // Initializers and inputs can follow the nodes on the wire, so they
+        // are bound in a first pass over the graph. Nodes are stored in
+        // topological order.
+        for (ProtoReader reader(graph); reader.next(f);)
+            if (f.number == 5)
+                importer.addConstant(TensorProto(f.bytes));
+        for (ProtoReader reader(graph); reader.next(f);)
+            if (f.number == 11)
+                importer.addInput(ValueInfo(f.bytes, dimParams));
+        for (ProtoReader reader(graph); reader.next(f);)
+            if (f.number == 1)
+                importer.addNode(NodeProto(f.bytes));
+        for (ProtoReader reader(graph); reader.next(f);)
+            if (f.number == 12)
+                importer.addOutput(ValueInfo(f.bytes, dimParams));
+        return importer.finish();
+    }
+
+} // namespace infini
@@ -7,28 +7,6 @@ namespace infini
     OperatorObj::OperatorObj(OpType opType, TensorVec inputs, TensorVec outputs)
         : type(opType), inputs(inputs), outputs(outputs) {}
 
-    void OperatorObj::removePredecessors(const Operator &op)
-    {
-        for (auto it = predecessors.begin(); it != predecessors.end();)
-        {
-            if (it->lock() == op)
-                it = predecessors.erase(it);
-            else
-                ++it;
-        }
-    }
-
-    void OperatorObj::removeSuccessors(const Operator &op)
-    {
-        for (auto it = successors.begin(); it != successors.end();)
-        {
-            if (it->lock() == op)
-                it = successors.erase(it);
-            else
-                ++it;
-        }
-    }
-
     void OperatorObj::replaceInput(Tensor t1, Tensor t2)
     {
         for (auto itr = inputs.begin(); itr != inputs.end(); ++itr)
@@ -69,6 +47,47 @@ namespace infini
         return true;
     }
 
+    int64_t OperatorObj::getBytesRead() const
+    {
+        int64_t bytes = 0;
+        for (const auto &input : inputs)
+            bytes += input->getBytes();
+        return bytes;
+    }
+
+    int64_t OperatorObj::getBytesWritten() const
+    {
+        int64_t bytes = 0;
+        for (const auto &output : outputs)
+            bytes += output->getBytes();
+        return bytes;
+    }
+
+    double OperatorObj::getArithmeticIntensity() const
+    {
+        auto bytes = getBytesRead() + getBytesWritten();
+        return bytes ? (double)getFlops() / bytes : 0;
+    }
+
+    bool OperatorObj::producesView() const
+    {
+        // Only outputs of view ops are ever bound as views.
+        return outputs.size() == 1 && outputs[0]->isView();
+    }
+
+    vector<int> OperatorObj::getWorkloadVector() const
+    {
+        vector<int> ret = getOpAttrVector();
+        ret.emplace_back(getDType().getIndex());
+        for (const auto &input : inputs)
+        {
+            const auto &dims = input->getDims();
+            ret.emplace_back(dims.size());
+            ret.insert(ret.end(), dims.begin(), dims.end());
+        }
+        return ret;
+    }
+
     optional<vector<Shape>> OperatorObj::inferShape() { return inferShape(inputs); }
 
     vector<DataType> OperatorObj::inferDataType(const TensorVec &inputs) const
@@ -0,0 +1,110 @@
+#include "core/pass_manager.h"
+#include "core/graph.h"
+#include <chrono>
+#include <iomanip>
+
+namespace infini
+{
+    namespace
+    {
+        struct GraphCost
+        {
+            long ops, tensors;
+            long long bytes, flops;
+        };
+
+        GraphCost measure(const GraphObj &graph)
+        {
+            return {(long)graph.getOperators().size(),
+                    (long)graph.getTensors().size(), graph.getBytesMoved(),
+                    graph.getFlops()};
+        }
+    } // namespace
+
+    vector<string> PassManager::defaultPipeline()
+    {
+        return {"fold-constants", "cse", "canonicalize-transpose",
+                "fuse-matmul-epilogue", "fuse-element-wise"};
+    }
+
+    PassManager::PassManager(vector<string> pipeline, int maxIterations)
+        : pipeline(std::move(pipeline)), maxIterations(maxIterations)
+    {
+        const auto &registry = PassRegistry::getInstance();
+        for (const auto &name : this->pipeline)
+        {
+            IT_ASSERT(registry.hasPass(name), "Pass not found: " + name);
+            PassStats stat;
+            stat.name = name;
+            stats.emplace_back(stat);
+        }
+    }
+
+    bool PassManager::run(GraphObj &graph)
+    {
+        using Clock = std::chrono::steady_clock;
+        const auto &registry = PassRegistry::getInstance();
+        bool changed = false;
+        for (int iter = 0; iter < maxIterations; ++iter)
+        {
+            ++iterations;
+            bool progress = false;
+            for (size_t i = 0; i < pipeline.size(); ++i)
+            {
+                auto &stat = stats[i];
+                auto before = measure(graph);
+                auto start = Clock::now();
+                bool passChanged = registry.getPass(pipeline[i])(graph);
+                stat.timeUs += std::chrono::duration<double, std::micro>(
+                                   Clock::now() - start)
+                                   .count();
+                auto after = measure(graph);
+                stat.runs++;
+                stat.changes += passChanged;
+                stat.opsRemoved += before.ops - after.ops;
+                stat.tensorsRemoved += before.tensors - after.tensors;
+                stat.bytesSaved += before.bytes - after.bytes;
+                stat.flopsSaved += before.flops - after.flops;
+                progress |= passChanged;
+            }
+            changed |= progress;
+            if (!progress)
+                break;
+        }
+        return changed;
+    }
+
+    string PassManager::summary() const
+    {
+        std::ostringstream oss;
+        oss << std::left << std::setw(24) << "Pass" << std::right
+            << std::setw(6) << "Runs" << std::setw(9) << "Changes"
+            << std::setw(8) << "Ops" << std::setw(9) << "Tensors"
+            << std::setw(14) << "Bytes" << std::setw(14) << "FLOPs"
+            << std::setw(12) << "Time(ms)" << "\n";
+        oss << std::fixed << std::setprecision(3);
+        for (const auto &stat : stats)
+            oss << std::left << std::setw(24) << stat.name << std::right
+                << std::setw(6) << stat.runs << std::setw(9) << stat.changes
+                << std::setw(8) << stat.opsRemoved << std::setw(9)
+                << stat.tensorsRemoved << std::setw(14) << stat.bytesSaved
+                << std::setw(14) << stat.flopsSaved << std::setw(12)
+                << stat.timeUs / 1000 << "\n";
+        oss << "Iterations: " << iterations << "\n";
+        return oss.str();
+    }
+
+} // namespace infini
+
+REGISTER_PASS("fold-constants",
+              [](GraphObj &graph) { return graph.foldConstants(); });
+REGISTER_PASS("cse", [](GraphObj &graph)
+              { return graph.eliminateCommonSubexpressions(); });
+REGISTER_PASS("canonicalize-transpose",
+              [](GraphObj &graph) { return graph.canonicalizeTranspose(); });
+REGISTER_PASS("fuse-matmul-epilogue",
+              [](GraphObj &graph) { return graph.fuseMatmulEpilogue(); });
+REGISTER_PASS("fuse-element-wise",
+              [](GraphObj &graph) { return graph.fuseElementWise(); });
+REGISTER_PASS("choose-layouts",
+              [](GraphObj &graph) { return graph.chooseLayouts(); });
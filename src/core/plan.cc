@@ -0,0 +1,143 @@
+#include "core/plan.h"
+#include "core/autotuner.h"
+#include "core/graph.h"
+#include <cstring>
+
+namespace infini
+{
+    void lowerTensor(const Tensor &tensor, TensorDesc &desc)
+    {
+        const auto &shape = tensor->getDims();
+        int rank = shape.size();
+        IT_ASSERT(rank <= MaxPlanRank, "Tensor rank " + std::to_string(rank) +
+                                           " exceeds the plan limit");
+        desc.data = tensor->getRawDataPtr<void *>();
+        desc.dtype = tensor->getDType();
+        desc.rank = rank;
+        desc.block = tensor->getBlock();
+        desc.size = tensor->size();
+        const auto strides = tensor->getStrides();
+        for (int i = MaxPlanRank - 1; i >= 0; --i)
+        {
+            if (i < rank)
+            {
+                desc.dims[i] = shape[i];
+                desc.strides[i] = strides[i];
+            }
+            else
+            {
+                desc.dims[i] = 1;
+                desc.strides[i] = 0;
+            }
+        }
+    }
+
+    void broadcastStrides(const TensorDesc &input, const TensorDesc &output,
+                          size_t *strides)
+    {
+        int shift = output.rank - input.rank;
+        for (int d = 0; d < MaxPlanRank; ++d)
+        {
+            int id = d - shift;
+            strides[d] = (d < output.rank && id >= 0 && input.dims[id] != 1)
+                             ? input.strides[id]
+                             : 0;
+        }
+    }
+
+    void lowerOperator(const Operator &op, const Kernel *kernel,
+                       vector<TensorDesc> &descs, OpRecord &record)
+    {
+        const auto &inputs = op->getInputs();
+        const auto &outputs = op->getOutputs();
+        size_t base = descs.size();
+        descs.resize(base + inputs.size() + outputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i)
+            lowerTensor(inputs[i], descs[base + i]);
+        for (size_t i = 0; i < outputs.size(); ++i)
+            lowerTensor(outputs[i], descs[base + inputs.size() + i]);
+
+        // Zero every byte so unused attribute storage is deterministic.
+        std::memset(&record, 0, sizeof(record));
+        record.kernel = kernel;
+        record.op = op.get();
+        record.opType = op->getOpType().underlying();
+        record.dtype = op->getDType();
+        record.numInputs = inputs.size();
+        record.numOutputs = outputs.size();
+        record.flops = op->getFlops();
+        record.inputs = descs.data() + base;
+        record.outputs = descs.data() + base + inputs.size();
+        if (!kernel->supportsBlockedLayouts())
+            for (int i = 0; i < record.numInputs + record.numOutputs; ++i)
+                IT_ASSERT(!descs[base + i].block,
+                          string("Blocked layout not supported by ") +
+                              op->getOpType().toString());
+        kernel->lower(op, record);
+    }
+
+    // The output of a view op already refers to its input.
+    static void skipView(const OpRecord &, const RuntimeObj *) {}
+
+    ExecutionPlanObj::ExecutionPlanObj(const GraphObj &graph,
+                                       const vector<string> *kernels)
+    {
+        const auto &kernelRegistry = KernelRegistry::getInstance();
+        auto &autotuner = Autotuner::getInstance();
+        const auto device = graph.getRuntime()->getDevice();
+        const auto &ops = graph.getOperators();
+        IT_ASSERT(!kernels || kernels->size() == ops.size());
+
+        size_t numDescs = 0;
+        for (const auto &op : ops)
+            numDescs += op->getInputs().size() + op->getOutputs().size();
+        // Reserve up front: records keep pointers into `descs`.
+        descs.reserve(numDescs);
+        records.resize(ops.size());
+        for (size_t i = 0; i < ops.size(); ++i)
+        {
+            auto kernelAttrs =
+                KernelAttrs{device, ops[i]->getOpType().underlying()};
+            const KernelRegistry::KernelRecord *named = nullptr;
+            if (kernels)
+            {
+                named = kernelRegistry.getKernelItem(kernelAttrs,
+                                                     (*kernels)[i]);
+                IT_ASSERT(named, "Kernel not found: " + (*kernels)[i]);
+            }
+            // A view op has nothing to run, so it is not worth tuning.
+            const bool view = ops[i]->producesView();
+            const auto &item = named ? *named
+                               : autotuner.isEnabled() && !view
+                                   ? autotuner.select(kernelAttrs, ops[i])
+                                   : kernelRegistry.getKernelItem(kernelAttrs);
+            Kernel *kernel = std::get<0>(item);
+            lowerOperator(ops[i], kernel, descs, records[i]);
+            records[i].kernelName = std::get<1>(item).c_str();
+            records[i].func = view ? skipView : kernel->resolve(records[i]);
+            IT_ASSERT(records[i].func != nullptr,
+                      "Kernel " + std::get<1>(item) +
+                          " does not support data type " +
+                          records[i].dtype.toString());
+
+            size_t desc = descs.size() - ops[i]->getInputs().size() -
+                          ops[i]->getOutputs().size();
+            for (const auto *list : {&ops[i]->getInputs(),
+                                     &ops[i]->getOutputs()})
+                for (const auto &tensor : *list)
+                {
+                    if (tensor->isExternal())
+                        externals.emplace_back(desc, tensor);
+                    ++desc;
+                }
+        }
+        IT_ASSERT(descs.size() == numDescs);
+    }
+
+    void ExecutionPlanObj::updateExternals()
+    {
+        for (auto &[desc, tensor] : externals)
+            descs[desc].data = tensor->getRawDataPtr<void *>();
+    }
+
+} // namespace infini
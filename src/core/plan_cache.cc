@@ -0,0 +1,248 @@
+#include "core/plan_cache.h"
+#include "core/serialize.h"
+#include "utils/mapped_file.h"
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+namespace infini
+{
+    namespace
+    {
+        // Bump when the entry format or the meaning of kernel names changes.
+        constexpr int CacheVersion = 3;
+
+        // A file name suffix no other writer uses, in this process or any
+        // other.
+        string tempSuffix()
+        {
+            static std::atomic<unsigned> counter{0};
+            return ".tmp." + std::to_string(getpid()) + "." +
+                   std::to_string(counter++);
+        }
+
+        // The graph file named by the plan file at `planPath`, or an empty
+        // string if there is none.
+        string graphFileOf(const string &planPath)
+        {
+            std::ifstream ifs(planPath);
+            string tag, value, graphFile;
+            ifs >> tag >> value >> tag >> value >> tag >> graphFile;
+            return !ifs.fail() && tag == "graph" ? graphFile : "";
+        }
+
+        // 64-bit FNV-1a.
+        struct Hasher
+        {
+            uint64_t state = 0xcbf29ce484222325ull;
+
+            void bytes(const void *data, size_t size)
+            {
+                auto p = static_cast<const unsigned char *>(data);
+                for (size_t i = 0; i < size; ++i)
+                    state = (state ^ p[i]) * 0x100000001b3ull;
+            }
+            template <typename T>
+            void value(T v) { bytes(&v, sizeof(v)); }
+            void ints(const vector<int> &values)
+            {
+                value(values.size());
+                bytes(values.data(), values.size() * sizeof(int));
+            }
+            string hex() const
+            {
+                std::ostringstream oss;
+                oss << std::hex << std::setw(16) << std::setfill('0')
+                    << state;
+                return oss.str();
+            }
+        };
+    } // namespace
+
+    PlanCache::PlanCache(string directory) : directory(std::move(directory))
+    {
+        std::filesystem::create_directories(this->directory);
+    }
+
+    string PlanCache::modelHash(const string &path)
+    {
+        size_t size;
+        auto mapping = mapFile(path, size);
+        Hasher hasher;
+        hasher.bytes(mapping.get(), size);
+        return hasher.hex();
+    }
+
+    string PlanCache::modelHash(const Graph &graph)
+    {
+        IT_ASSERT(graph->topo_sort());
+        Hasher hasher;
+        const auto &tensors = graph->getTensors();
+        std::unordered_map<const TensorObj *, int> index;
+        for (size_t i = 0; i < tensors.size(); ++i)
+        {
+            const auto &tensor = tensors[i];
+            index.emplace(tensor.get(), i);
+            hasher.value(tensor->getDType().getIndex());
+            hasher.ints(tensor->getDims());
+            hasher.value(tensor->getBlock());
+            hasher.value(tensor->isConstant());
+            if (tensor->isConstant())
+                hasher.bytes(tensor->getRawDataPtr<void *>(),
+                             tensor->getBytes());
+        }
+        for (const auto &op : graph->getOperators())
+        {
+            hasher.ints(op->getOpAttrVector());
+            for (const auto *list : {&op->getInputs(), &op->getOutputs()})
+            {
+                hasher.value(list->size());
+                for (const auto &tensor : *list)
+                    hasher.value(index.at(tensor.get()));
+            }
+        }
+        return hasher.hex();
+    }
+
+    string PlanCache::cpuFeatures()
+    {
+        string features;
+#if defined(__x86_64__) || defined(__i386__)
+        auto add = [&](bool supported, const char *name)
+        {
+            if (!supported)
+                return;
+            if (!features.empty())
+                features += ',';
+            features += name;
+        };
+        __builtin_cpu_init();
+        add(__builtin_cpu_supports("sse4.2"), "sse4.2");
+        add(__builtin_cpu_supports("avx"), "avx");
+        add(__builtin_cpu_supports("avx2"), "avx2");
+        add(__builtin_cpu_supports("fma"), "fma");
+        add(__builtin_cpu_supports("avx512f"), "avx512f");
+#endif
+        return features.empty() ? "generic" : features;
+    }
+
+    string PlanCache::entryPath(const string &modelHash) const
+    {
+        Hasher hasher;
+        hasher.value(CacheVersion);
+        hasher.bytes(modelHash.data(), modelHash.size());
+        auto features = cpuFeatures();
+        hasher.bytes(features.data(), features.size());
+        return (std::filesystem::path(directory) / hasher.hex()).string();
+    }
+
+    void PlanCache::store(const string &modelHash, const Graph &graph,
+                          const ExecutionPlan &plan) const
+    {
+        const auto &memoryPlan = graph->getMemoryPlan();
+        IT_ASSERT(memoryPlan.offsets.size() == graph->getTensors().size(),
+                  "Graph must be allocated before it is cached");
+        IT_ASSERT(plan->size() == graph->getOperators().size(),
+                  "Plan was not compiled from this graph");
+
+        // Every file is written under a unique temporary name and renamed
+        // into place. The graph file is named after the hash of its
+        // contents, so once in place it never changes, and the plan file
+        // names it. Renaming the plan file is therefore the single commit
+        // point: a concurrent load sees either the old entry or the new one.
+        // The graph file of the old entry is removed afterwards.
+        const auto path = entryPath(modelHash);
+        const auto oldGraphFile = graphFileOf(path + ".plan");
+        const auto graphPath = path + "." + PlanCache::modelHash(graph) +
+                               ".graph";
+        const auto graphTemp = graphPath + tempSuffix();
+        saveGraph(graph, graphTemp);
+        std::filesystem::rename(graphTemp, graphPath);
+
+        const auto planTemp = path + ".plan" + tempSuffix();
+        {
+            std::ofstream ofs(planTemp);
+            IT_ASSERT(ofs.is_open(), "Cannot open " + planTemp);
+            ofs << "itplan " << CacheVersion << "\n"
+                << "features " << cpuFeatures() << "\n"
+                << "graph "
+                << std::filesystem::path(graphPath).filename().string()
+                << "\n"
+                << "arena " << memoryPlan.size << "\n"
+                << "tensors " << memoryPlan.offsets.size() << "\n";
+            for (auto offset : memoryPlan.offsets)
+                ofs << offset << "\n";
+            ofs << "kernels " << plan->size() << "\n";
+            for (const auto &record : plan->getRecords())
+                ofs << record.kernelName << "\n";
+            IT_ASSERT(ofs.good(), "Failed to write " + planTemp);
+        }
+        std::filesystem::rename(planTemp, path + ".plan");
+        const auto graphFile = std::filesystem::path(graphPath).filename();
+        if (!oldGraphFile.empty() && oldGraphFile != graphFile.string())
+        {
+            std::error_code ec;
+            std::filesystem::remove(
+                std::filesystem::path(directory) / oldGraphFile, ec);
+        }
+    }
+
+    std::optional<PlanCache::Entry>
+    PlanCache::load(Runtime runtime, const string &modelHash) const
+    {
+        const auto path = entryPath(modelHash);
+        std::ifstream ifs(path + ".plan");
+        if (!ifs.is_open())
+            return std::nullopt;
+
+        string tag, features, graphFile;
+        int version = 0;
+        size_t numOffsets = 0, numKernels = 0;
+        MemoryPlan memoryPlan;
+        ifs >> tag >> version;
+        if (tag != "itplan" || version != CacheVersion)
+            return std::nullopt;
+        ifs >> tag >> features;
+        // Guards against hash collisions between feature sets.
+        if (tag != "features" || features != cpuFeatures())
+            return std::nullopt;
+        ifs >> tag >> graphFile >> tag >> memoryPlan.size >> tag >> numOffsets;
+        memoryPlan.offsets.resize(numOffsets);
+        for (auto &offset : memoryPlan.offsets)
+            ifs >> offset;
+        ifs >> tag >> numKernels;
+        vector<string> kernels(numKernels);
+        for (auto &kernel : kernels)
+            ifs >> kernel;
+        IT_ASSERT(!ifs.fail(), "Corrupt plan cache entry " + path);
+        const auto graphPath =
+            (std::filesystem::path(directory) / graphFile).string();
+        if (!std::filesystem::exists(graphPath))
+            return std::nullopt;
+
+        Entry entry;
+        entry.graph = loadGraph(runtime, graphPath);
+        // Kernels renamed or removed since the entry was stored make it
+        // stale.
+        const auto &ops = entry.graph->getOperators();
+        if (kernels.size() != ops.size())
+            return std::nullopt;
+        const auto &registry = KernelRegistry::getInstance();
+        for (size_t i = 0; i < ops.size(); ++i)
+        {
+            auto attrs = KernelAttrs{runtime->getDevice(),
+                                     ops[i]->getOpType().underlying()};
+            if (!registry.hasKernel(attrs) ||
+                !registry.getKernelItem(attrs, kernels[i]))
+                return std::nullopt;
+        }
+        entry.graph->dataMalloc(memoryPlan);
+        entry.plan = entry.graph->compile(kernels);
+        return entry;
+    }
+
+} // namespace infini
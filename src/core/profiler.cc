@@ -0,0 +1,154 @@
+#include "core/profiler.h"
+#include "core/operator.h"
+#include <fstream>
+#include <iomanip>
+
+namespace infini
+{
+    static size_t descBytes(const TensorDesc &desc)
+    {
+        return desc.size * desc.dtype.getSize();
+    }
+
+    void Profiler::end(const OpRecord &record, const Sample &startSample)
+    {
+        auto end = Clock::now();
+        auto &event = events.emplace_back();
+        if (perfCounters.isOpen())
+        {
+            event.hasCounters = true;
+            event.counters = perfCounters.read() - startSample.counters;
+        }
+        auto start = startSample.time;
+        if (!origin)
+            origin = start;
+        using Us = std::chrono::duration<double, std::micro>;
+        event.guid = record.op ? record.op->getGuid() : 0;
+        event.opType = record.opType;
+        event.kernelName = record.kernelName ? record.kernelName : "";
+        event.startUs = Us(start - *origin).count();
+        event.durationUs = Us(end - start).count();
+        for (int i = 0; i < record.numInputs; ++i)
+            event.bytesRead += descBytes(record.inputs[i]);
+        for (int i = 0; i < record.numOutputs; ++i)
+            event.bytesWritten += descBytes(record.outputs[i]);
+        event.flops = estimateFlops(record);
+    }
+
+    size_t Profiler::estimateFlops(const OpRecord &record)
+    {
+        return record.flops;
+    }
+
+    string Profiler::summary() const
+    {
+        struct Row
+        {
+            size_t count = 0;
+            double us = 0;
+            size_t bytes = 0, flops = 0;
+            PerfCounterValues counters;
+        };
+        std::map<OpType, Row> rows;
+        double totalUs = 0;
+        bool hasCounters = false;
+        for (const auto &event : events)
+        {
+            auto &row = rows[OpType(event.opType)];
+            if (event.hasCounters)
+            {
+                hasCounters = true;
+                row.counters += event.counters;
+            }
+            row.count++;
+            row.us += event.durationUs;
+            row.bytes += event.bytesRead + event.bytesWritten;
+            row.flops += event.flops;
+            totalUs += event.durationUs;
+        }
+
+        std::ostringstream oss;
+        oss << std::left << std::setw(12) << "Op" << std::right
+            << std::setw(8) << "Count" << std::setw(12) << "Time(ms)"
+            << std::setw(9) << "Pct" << std::setw(11) << "GB/s"
+            << std::setw(11) << "GFLOP/s";
+        if (hasCounters)
+            oss << std::setw(8) << "IPC" << std::setw(10) << "LLCMiss"
+                << std::setw(10) << "BrMiss";
+        oss << "\n";
+        oss << std::fixed;
+        for (const auto &[type, row] : rows)
+        {
+            double seconds = row.us * 1e-6;
+            oss << std::left << std::setw(12) << type.toString() << std::right
+                << std::setw(8) << row.count << std::setw(12)
+                << std::setprecision(3) << row.us / 1000 << std::setw(8)
+                << std::setprecision(1)
+                << (totalUs > 0 ? row.us / totalUs * 100 : 0) << "%"
+                << std::setw(11) << std::setprecision(2)
+                << (seconds > 0 ? row.bytes / seconds * 1e-9 : 0)
+                << std::setw(11)
+                << (seconds > 0 ? row.flops / seconds * 1e-9 : 0);
+            if (hasCounters)
+                oss << std::setw(8) << row.counters.ipc() << std::setw(9)
+                    << row.counters.llcMissRate() * 100 << "%"
+                    << std::setw(9) << row.counters.branchMissRate() * 100
+                    << "%";
+            oss << "\n";
+        }
+        oss << std::left << std::setw(12) << "Total" << std::right
+            << std::setw(8) << events.size() << std::setw(12)
+            << std::setprecision(3) << totalUs / 1000 << "\n";
+        return oss.str();
+    }
+
+    string Profiler::counterReport() const
+    {
+        std::ostringstream oss;
+        oss << std::left << std::setw(10) << "Guid" << std::setw(12) << "Op"
+            << std::setw(22) << "Kernel" << std::right << std::setw(14)
+            << "Cycles" << std::setw(8) << "IPC" << std::setw(10) << "LLCMiss"
+            << std::setw(10) << "BrMiss" << "\n";
+        oss << std::fixed << std::setprecision(2);
+        for (const auto &e : events)
+        {
+            if (!e.hasCounters)
+                continue;
+            oss << std::left << std::setw(10) << e.guid << std::setw(12)
+                << OpType(e.opType).toString() << std::setw(22)
+                << e.kernelName << std::right << std::setw(14)
+                << e.counters.cycles << std::setw(8) << e.counters.ipc()
+                << std::setw(9) << e.counters.llcMissRate() * 100 << "%"
+                << std::setw(9) << e.counters.branchMissRate() * 100 << "%\n";
+        }
+        return oss.str();
+    }
+
+    void Profiler::dumpChromeTrace(const string &path) const
+    {
+        std::ofstream ofs(path);
+        IT_ASSERT(ofs.is_open(), "Cannot open " + path);
+        ofs << std::fixed << std::setprecision(3);
+        ofs << "{\"traceEvents\":[";
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            const auto &e = events[i];
+            ofs << (i ? ",\n" : "\n") << "{\"name\":\""
+                << OpType(e.opType).toString() << "\",\"cat\":\""
+                << e.kernelName << "\",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+                << ",\"ts\":" << e.startUs << ",\"dur\":" << e.durationUs
+                << ",\"args\":{\"guid\":" << e.guid << ",\"kernel\":\""
+                << e.kernelName << "\",\"bytesRead\":" << e.bytesRead
+                << ",\"bytesWritten\":" << e.bytesWritten
+                << ",\"flops\":" << e.flops;
+            if (e.hasCounters)
+                ofs << ",\"cycles\":" << e.counters.cycles
+                    << ",\"instructions\":" << e.counters.instructions
+                    << ",\"llcMisses\":" << e.counters.llcMisses
+                    << ",\"branchMisses\":" << e.counters.branchMisses;
+            ofs << "}}";
+        }
+        ofs << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+
+} // namespace infini
@@ -1,8 +1,10 @@
 #include "core/runtime.h"
+#include "core/autotuner.h"
 #include "core/blob.h"
 #include "core/kernel.h"
 #include "core/graph.h"
-#include "core/kernel.h"
+#include "core/plan.h"
+#include "core/profiler.h"
 #include <chrono>
 #include <cstring>
 #include <memory>
@@ -10,16 +12,43 @@ namespace infini
 {
     void NativeCpuRuntimeObj::run(const Graph &graph) const
     {
+        if (graph->isCaptureEnabled())
+            return run(graph->getCapturedPlan());
+        // Profiling needs the resolved records and autotuning picks kernels
+        // while lowering, so both go through a fresh plan.
+        if (Profiler::getInstance().isEnabled() ||
+            Autotuner::getInstance().isEnabled())
+            return run(graph->compile());
+
         const auto &kernelRegistry = KernelRegistry::getInstance();
 
         for (auto &op : graph->getOperators())
         {
+            if (op->producesView())
+                continue;
             auto kernelAttrs = KernelAttrs{device, op->getOpType().underlying()};
             Kernel *kernel = kernelRegistry.getKernel(kernelAttrs);
             kernel->compute(op, this);
         }
     }
 
+    void NativeCpuRuntimeObj::run(const ExecutionPlan &plan) const
+    {
+        auto &profiler = Profiler::getInstance();
+        if (!profiler.isEnabled())
+        {
+            for (const auto &record : plan->getRecords())
+                record.func(record, this);
+            return;
+        }
+        for (const auto &record : plan->getRecords())
+        {
+            auto sample = profiler.begin();
+            record.func(record, this);
+            profiler.end(record, sample);
+        }
+    }
+
     string NativeCpuRuntimeObj::toString() const { return "CPU Runtime"; }
 
     void NativeCpuRuntimeObj::dealloc(void *ptr)
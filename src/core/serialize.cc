@@ -0,0 +1,290 @@
+#include "core/serialize.h"
+#include "core/blob.h"
+#include "core/runtime.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/fused_element_wise.h"
+#include "operators/matmul.h"
+#include "operators/reorder.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include "utils/mapped_file.h"
+#include <cstring>
+#include <fstream>
+
+namespace infini
+{
+    namespace
+    {
+        constexpr char Magic[8] = {'I', 'T', 'G', 'R', 'A', 'P', 'H', '\0'};
+        constexpr uint32_t Version = 2;
+        constexpr size_t PayloadAlignment = 64;
+
+        size_t alignUp(size_t offset)
+        {
+            return (offset + PayloadAlignment - 1) / PayloadAlignment *
+                   PayloadAlignment;
+        }
+
+        struct Writer
+        {
+            vector<char> bytes;
+
+            template <typename T>
+            void put(T value)
+            {
+                auto p = reinterpret_cast<const char *>(&value);
+                bytes.insert(bytes.end(), p, p + sizeof(T));
+            }
+            void putInts(const vector<int> &values)
+            {
+                put<int32_t>(values.size());
+                for (int value : values)
+                    put<int32_t>(value);
+            }
+            template <typename T>
+            void patch(size_t pos, T value)
+            {
+                std::memcpy(bytes.data() + pos, &value, sizeof(T));
+            }
+        };
+
+        struct Reader
+        {
+            const char *data;
+            size_t size, pos = 0;
+
+            template <typename T>
+            T get()
+            {
+                IT_ASSERT(pos + sizeof(T) <= size, "Truncated graph file");
+                T value;
+                std::memcpy(&value, data + pos, sizeof(T));
+                pos += sizeof(T);
+                return value;
+            }
+            vector<int> getInts()
+            {
+                auto n = get<int32_t>();
+                IT_ASSERT(n >= 0 && pos + n * sizeof(int32_t) <= size,
+                          "Truncated graph file");
+                vector<int> values(n);
+                for (auto &value : values)
+                    value = get<int32_t>();
+                return values;
+            }
+        };
+
+        std::optional<float> optionalBits(int has, int bits)
+        {
+            if (!has)
+                return std::nullopt;
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        /**
+         * @brief Recreates an operator from the attribute vector returned by
+         * its getOpAttrVector.
+         */
+        void addOperator(GraphObj &g, const vector<int> &attrs,
+                         const TensorVec &in, const TensorVec &out)
+        {
+            IT_ASSERT(!attrs.empty());
+            switch (attrs[0])
+            {
+            case OpType::Add:
+                g.addOpWithOutputs<AddObj>(in[0], in[1], out[0]);
+                break;
+            case OpType::Sub:
+                g.addOpWithOutputs<SubObj>(in[0], in[1], out[0]);
+                break;
+            case OpType::Mul:
+                g.addOpWithOutputs<MulObj>(in[0], in[1], out[0]);
+                break;
+            case OpType::Div:
+                g.addOpWithOutputs<DivObj>(in[0], in[1], out[0]);
+                break;
+            case OpType::Relu:
+                g.addOpWithOutputs<ReluObj>(in[0], out[0]);
+                break;
+            case OpType::Clip:
+                IT_ASSERT(attrs.size() == 5);
+                g.addOpWithOutputs<ClipObj>(in[0], out[0],
+                                            optionalBits(attrs[1], attrs[2]),
+                                            optionalBits(attrs[3], attrs[4]));
+                break;
+            case OpType::Cast:
+                IT_ASSERT(attrs.size() == 2);
+                g.addOpWithOutputs<CastObj>(in[0], out[0],
+                                            static_cast<CastType>(attrs[1]));
+                break;
+            case OpType::MatMul:
+            {
+                IT_ASSERT(attrs.size() == 7);
+                auto op = g.addOpWithOutputs<MatmulObj>(
+                    in[0], in[1], out[0], attrs[1], attrs[2],
+                    in.size() > 2 ? in[2] : nullptr);
+                op->setClamp(optionalBits(attrs[3], attrs[4]),
+                             optionalBits(attrs[5], attrs[6]));
+                break;
+            }
+            case OpType::Transpose:
+                g.addOpWithOutputs<TransposeObj>(
+                    in[0], out[0], Shape(attrs.begin() + 1, attrs.end()));
+                break;
+            case OpType::Concat:
+                IT_ASSERT(attrs.size() == 2);
+                g.addOpWithOutputs<ConcatObj>(in, out[0], attrs[1]);
+                break;
+            case OpType::Reorder:
+                IT_ASSERT(attrs.size() == 2);
+                g.addOpWithOutputs<ReorderObj>(in[0], out[0], attrs[1]);
+                break;
+            case OpType::FusedElementWise:
+            {
+                IT_ASSERT(attrs.size() % 6 == 1);
+                vector<FusedStep> program;
+                for (size_t i = 1; i < attrs.size(); i += 6)
+                {
+                    auto min = optionalBits(attrs[i + 2], attrs[i + 3]);
+                    auto max = optionalBits(attrs[i + 4], attrs[i + 5]);
+                    program.push_back(
+                        {static_cast<OpType::underlying_t>(attrs[i]),
+                         attrs[i + 1], min.value_or(0), max.value_or(0),
+                         min.has_value(), max.has_value()});
+                }
+                g.addOpWithOutputs<FusedElementWiseObj>(in, out[0], program);
+                break;
+            }
+            default:
+                IT_TODO_HALT_MSG("Cannot load operator " +
+                                 string(OpType(attrs[0]).toString()));
+            }
+        }
+    } // namespace
+
+    void saveGraph(const Graph &graph, const string &path)
+    {
+        IT_ASSERT(graph->topo_sort());
+        const auto &tensors = graph->getTensors();
+        const auto &ops = graph->getOperators();
+        std::unordered_map<const TensorObj *, int> index;
+
+        Writer meta;
+        meta.bytes.insert(meta.bytes.end(), Magic, Magic + sizeof(Magic));
+        meta.put<uint32_t>(Version);
+        meta.put<uint32_t>(tensors.size());
+        meta.put<uint32_t>(ops.size());
+        vector<size_t> offsetPos(tensors.size());
+        for (size_t i = 0; i < tensors.size(); ++i)
+        {
+            const auto &tensor = tensors[i];
+            index.emplace(tensor.get(), i);
+            meta.put<int32_t>(tensor->getDType().getIndex());
+            meta.putInts(tensor->getDims());
+            meta.put<int32_t>(tensor->getBlock());
+            meta.put<uint32_t>(tensor->isConstant());
+            offsetPos[i] = meta.bytes.size();
+            meta.put<uint64_t>(0); // payload offset, patched below
+            meta.put<uint64_t>(0); // payload size
+        }
+        for (const auto &op : ops)
+        {
+            meta.putInts(op->getOpAttrVector());
+            for (const auto *list : {&op->getInputs(), &op->getOutputs()})
+            {
+                meta.put<int32_t>(list->size());
+                for (const auto &tensor : *list)
+                    meta.put<int32_t>(index.at(tensor.get()));
+            }
+        }
+
+        size_t offset = meta.bytes.size();
+        for (size_t i = 0; i < tensors.size(); ++i)
+            if (tensors[i]->isConstant())
+            {
+                offset = alignUp(offset);
+                meta.patch<uint64_t>(offsetPos[i], offset);
+                meta.patch<uint64_t>(offsetPos[i] + 8,
+                                     tensors[i]->getBytes());
+                offset += tensors[i]->getBytes();
+            }
+
+        std::ofstream ofs(path, std::ios::binary);
+        IT_ASSERT(ofs.is_open(), "Cannot open " + path);
+        ofs.write(meta.bytes.data(), meta.bytes.size());
+        size_t written = meta.bytes.size();
+        const char zeros[PayloadAlignment] = {0};
+        for (const auto &tensor : tensors)
+            if (tensor->isConstant())
+            {
+                ofs.write(zeros, alignUp(written) - written);
+                ofs.write(tensor->getRawDataPtr<char *>(), tensor->getBytes());
+                written = alignUp(written) + tensor->getBytes();
+            }
+        IT_ASSERT(ofs.good(), "Failed to write " + path);
+    }
+
+    Graph loadGraph(Runtime runtime, const string &path)
+    {
+        size_t size;
+        auto mapping = mapFile(path, size);
+        void *addr = mapping.get();
+
+        Reader in{static_cast<const char *>(addr), size};
+        char magic[sizeof(Magic)];
+        for (auto &c : magic)
+            c = in.get<char>();
+        IT_ASSERT(std::memcmp(magic, Magic, sizeof(Magic)) == 0,
+                  path + " is not a graph file");
+        IT_ASSERT(in.get<uint32_t>() == Version,
+                  "Unsupported graph file version");
+        auto numTensors = in.get<uint32_t>();
+        auto numOps = in.get<uint32_t>();
+
+        Graph graph = make_ref<GraphObj>(runtime);
+        TensorVec tensors;
+        for (uint32_t i = 0; i < numTensors; ++i)
+        {
+            DataType dtype(in.get<int32_t>());
+            auto tensor = graph->addTensor(in.getInts(), dtype);
+            if (auto block = in.get<int32_t>())
+                tensor->setBlock(block);
+            bool constant = in.get<uint32_t>();
+            auto offset = in.get<uint64_t>();
+            auto bytes = in.get<uint64_t>();
+            if (constant)
+            {
+                IT_ASSERT(bytes == tensor->getBytes() && offset <= size &&
+                              bytes <= size - offset,
+                          "Bad constant payload in " + path);
+                tensor->setConstant(make_ref<BlobObj>(
+                    runtime, static_cast<char *>(addr) + offset, mapping));
+            }
+            tensors.emplace_back(tensor);
+        }
+        auto lookup = [&](const vector<int> &indices)
+        {
+            TensorVec ret;
+            for (int i : indices)
+            {
+                IT_ASSERT(0 <= i && i < (int)tensors.size());
+                ret.emplace_back(tensors[i]);
+            }
+            return ret;
+        };
+        for (uint32_t i = 0; i < numOps; ++i)
+        {
+            auto attrs = in.getInts();
+            auto inputs = lookup(in.getInts());
+            auto outputs = lookup(in.getInts());
+            addOperator(*graph, attrs, inputs, outputs);
+        }
+        // Operators were saved in topological order.
+        graph->markSorted();
+        return graph;
+    }
+
+} // namespace infini
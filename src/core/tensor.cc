@@ -21,11 +21,13 @@ namespace infini {
             ss << "nullptr data";
         string ret = "Tensor " + std::to_string(guid) + ", Fuid " +
                      std::to_string(fuid) + ", shape " + vecToString(shape) +
-                     ", dtype " + dtype.toString() + ", " + runtime->toString() +
+                     ", dtype " + dtype.toString() +
+                     (isBlocked() ? ", block " + std::to_string(block) : "") +
+                     ", " + runtime->toString() +
                      ", " + ss.str() + "\n";
         vector<UidBaseType> targetGuids;
-        for (const auto &op : targets)
-            targetGuids.emplace_back(op.lock()->getGuid());
+        for (const auto &op : getTargets())
+            targetGuids.emplace_back(op->getGuid());
         if (auto o = source.lock())
             ret += ", source " + std::to_string(o->getGuid());
         else
@@ -34,7 +36,8 @@ namespace infini {
         return ret;
     }
 
-void TensorObj::setShape(Shape shape_) {
+void TensorObj::setShape(const Shape &shape_) {
+    clearView();
     shape = shape_;
     size_t size = std::accumulate(shape.begin(), shape.end(), 1,
                                   [](auto acc, auto x) { return acc * x; });
@@ -70,47 +73,115 @@ void TensorObj::printData() const {
 #undef TRY_PRINT
 }
 
-bool TensorObj::equalData(const Tensor &rhs, double relativeError) const {
+CompareResult TensorObj::compare(const Tensor &rhs,
+                                 double relativeError) const {
     IT_ASSERT(data != nullptr);
     IT_ASSERT(rhs->data != nullptr);
+    IT_ASSERT(isContiguous() && rhs->isContiguous());
+    IT_ASSERT(!isBlocked() && !rhs->isBlocked());
     IT_ASSERT(getDType() == rhs->getDType());
     IT_ASSERT(runtime->isCpu());
     IT_ASSERT(rhs->getRuntime()->isCpu());
+    IT_ASSERT(size() == rhs->size());
+    return compareData(getRawDataPtr<void *>(), rhs->getRawDataPtr<void *>(),
+                       size(), dtype, relativeError);
+}
+
+bool TensorObj::equalData(const Tensor &rhs, double relativeError) const {
     if (size() != rhs->size())
         return false;
+    return reportEqual(compare(rhs, relativeError));
+}
 
-#define TEST_EQUAL(N)                                                          \
-    if (dtype == DataType(N))                                                  \
-        return equalDataImpl(getRawDataPtr<DT<N>::t *>(),                      \
-                             rhs->getRawDataPtr<DT<N>::t *>(), size(),         \
-                             relativeError);
-
-    TEST_EQUAL(0)           // fmt: new line
-    else TEST_EQUAL(1)      //
-        else TEST_EQUAL(2)  //
-        else TEST_EQUAL(3)  //
-        else TEST_EQUAL(4)  //
-        else TEST_EQUAL(5)  //
-        else TEST_EQUAL(6)  //
-        else TEST_EQUAL(7)  //
-        else TEST_EQUAL(8)  //
-        else TEST_EQUAL(9)  //
-        else TEST_EQUAL(10) //
-        else TEST_EQUAL(11) //
-        else TEST_EQUAL(12) //
-        else TEST_EQUAL(13) //
-        else TEST_EQUAL(16) //
-        else IT_TODO_HALT();
-
-#undef TEST_EQUAL
+bool TensorObj::reportEqual(const CompareResult &result) {
+    if (!result.equal())
+        printf("%s\n", result.toString().c_str());
+    return result.equal();
 }
 
 void TensorObj::setData(
     const std::function<void(void *, size_t, DataType)> &generator) const {
     IT_ASSERT(data != nullptr);
+    IT_ASSERT(isContiguous() && !isBlocked());
     generator(getRawDataPtr<void *>(), size(), dtype);
 }
 
-void TensorObj::setDataBlob(const Blob &blob) { this->data = blob; }
+void TensorObj::setDataBlob(const Blob &blob) {
+    clearView();
+    this->data = blob;
+}
+
+vector<size_t> TensorObj::getStrides() const {
+    if (isView())
+        return viewStrides;
+    vector<size_t> strides(shape.size());
+    size_t stride = 1;
+    for (int i = (int)shape.size() - 1; i >= 0; --i) {
+        strides[i] = stride;
+        stride *= shape[i];
+    }
+    return strides;
+}
+
+bool TensorObj::isContiguous() const {
+    if (!isView())
+        return true;
+    size_t stride = 1;
+    for (int i = (int)shape.size() - 1; i >= 0; --i) {
+        if (shape[i] != 1 && viewStrides[i] != stride)
+            return false;
+        stride *= shape[i];
+    }
+    return true;
+}
+
+size_t TensorObj::getPhysicalSize() const {
+    if (!isBlocked() || shape.empty() || _size == 0)
+        return _size;
+    size_t cols = shape.back();
+    return _size / cols * ((cols + block - 1) / block * block);
+}
+
+void TensorObj::setBlock(int block_) {
+    IT_ASSERT(block_ >= 0);
+    IT_ASSERT(!constant, "Cannot change the layout of a constant");
+    IT_ASSERT(!shape.empty() || block_ == 0);
+    block = block_;
+}
+
+void TensorObj::setView(const Tensor &base, vector<size_t> strides,
+                        size_t offset) {
+    IT_ASSERT(base->data != nullptr);
+    IT_ASSERT(strides.size() == shape.size());
+    // The view shares ownership of the data it refers to.
+    data = make_ref<BlobObj>(runtime, base->getRawDataPtr<char *>() + offset,
+                             base->data);
+    viewStrides = std::move(strides);
+    viewOffset = offset;
+}
+
+void TensorObj::setConstant() {
+    clearView();
+    data = make_ref<BlobObj>(runtime, getBytes());
+    constant = true;
+}
+
+void TensorObj::setConstant(
+    const std::function<void(void *, size_t, DataType)> &generator) {
+    setConstant();
+    setData(generator);
+}
+
+void TensorObj::setConstant(const void *src) {
+    setConstant();
+    std::memcpy(getRawDataPtr<void *>(), src, getBytes());
+}
+
+void TensorObj::setConstant(const Blob &blob) {
+    IT_ASSERT(blob != nullptr);
+    clearView();
+    data = blob;
+    constant = true;
+}
 
 }; // namespace infini
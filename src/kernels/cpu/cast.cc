@@ -0,0 +1,86 @@
+#include "operators/unary.h"
+#include "core/kernel.h"
+#include "utils/float16.h"
+
+namespace infini
+{
+    class NativeCast : public CpuKernelWithoutConfig
+    {
+        // Float16 and BFloat16 are both stored as uint16_t, so conversions
+        // are selected by data type index rather than by C++ type.
+        template <int N>
+        static auto load(typename DT<N>::t val)
+        {
+            if constexpr (N == 10) // DataType::Float16
+                return fp16ToFloat(val);
+            else if constexpr (N == 16) // DataType::BFloat16
+                return bf16ToFloat(val);
+            else
+                return val;
+        }
+
+        template <int N, typename V>
+        static typename DT<N>::t store(V val)
+        {
+            if constexpr (N == 10)
+                return floatToFp16((float)val);
+            else if constexpr (N == 16)
+                return floatToBf16((float)val);
+            else
+                return static_cast<typename DT<N>::t>(val);
+        }
+
+        template <int From, int To>
+        static void doCompute(const OpRecord &record, const RuntimeObj *context)
+        {
+            auto inptr = record.inputs[0].getPtr<typename DT<From>::t *>();
+            auto outptr = record.outputs[0].getPtr<typename DT<To>::t *>();
+            auto n = record.outputs[0].size;
+            for (size_t i = 0; i < n; ++i)
+                outptr[i] = store<To>(load<From>(inptr[i]));
+        }
+
+    public:
+        KernelFunc resolve(const OpRecord &record) const override
+        {
+            int from = record.inputs[0].dtype.getIndex();
+            int to = record.outputs[0].dtype.getIndex();
+#define CASE(FROM, TO)                \
+    if (from == FROM && to == TO)     \
+        return doCompute<FROM, TO>;
+
+            // Float32 = 1, UInt8 = 2, Int8 = 3, Int16 = 5, Int32 = 6,
+            // Int64 = 7, Float16 = 10, UInt32 = 12, BFloat16 = 16
+            CASE(1, 1)
+            CASE(1, 3)
+            CASE(1, 5)
+            CASE(1, 6)
+            CASE(1, 7)
+            CASE(1, 10)
+            CASE(1, 16)
+            CASE(2, 1)
+            CASE(2, 6)
+            CASE(2, 7)
+            CASE(3, 1)
+            CASE(3, 5)
+            CASE(3, 6)
+            CASE(5, 1)
+            CASE(5, 6)
+            CASE(6, 1)
+            CASE(6, 3)
+            CASE(6, 5)
+            CASE(6, 7)
+            CASE(7, 1)
+            CASE(7, 6)
+            CASE(7, 12)
+            CASE(10, 1)
+            CASE(12, 7)
+            CASE(16, 1)
+#undef CASE
+            return nullptr;
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::Cast, NativeCast, "Cast_CPU");
+
+}; // namespace infini
@@ -5,56 +5,49 @@ namespace infini {
 
 class NaiveConcat : public CpuKernelWithoutConfig {
     template <typename T>
-    void doCompute(const Operator &_op, const RuntimeObj *context) const {
-        auto op = as<ConcatObj>(_op);
-        auto inputs = op->getInputs(), outputs = op->getOutputs();
-        auto dim = op->getDim();
-        auto output = outputs[0];
-        std::vector<Shape> iDims;
-        for (auto input : inputs)
-            iDims.emplace_back(input->getDims());
-        const auto &outDim = output->getDims();
+    static void doCompute(const OpRecord &record, const RuntimeObj *context) {
+        auto dim = record.attrs.concat.axis;
+        const auto &output = record.outputs[0];
+        const auto *outDim = output.dims;
         size_t blockOffsetInner = 1;
-        for (size_t i = outDim.size() - 1; i > (size_t)dim; --i)
+        for (size_t i = output.rank - 1; i > (size_t)dim; --i)
             blockOffsetInner *= outDim[i];
         size_t blockOffset = outDim[dim] * blockOffsetInner;
-        for (size_t i = 0; i < inputs.size(); ++i) {
-            auto input = inputs[i];
-            auto dimOffset = 0;
-            auto iDim = iDims[i];
-            for (size_t j = 0; j < i; ++j)
-                dimOffset += iDims[j][dim];
+        auto dimOffset = 0;
+        for (int i = 0; i < record.numInputs; ++i) {
+            const auto &input = record.inputs[i];
             size_t localBlockOffset = 1;
-            for (size_t i = iDim.size() - 1;
+            for (size_t i = input.rank - 1;
                  i >= (size_t)dim && i != (size_t)-1; --i)
-                localBlockOffset *= iDim[i];
+                localBlockOffset *= input.dims[i];
             auto innerOffset = blockOffsetInner * dimOffset;
-            auto inSize = input->size();
-            auto inPtr = input->getRawDataPtr<T *>(),
-                 outPtr = output->getRawDataPtr<T *>();
+            auto inSize = input.size;
+            auto inPtr = input.getPtr<T *>(), outPtr = output.getPtr<T *>();
 #pragma omp parallel for
             for (size_t iOffset = 0; iOffset < inSize; ++iOffset) {
                 auto oOffset = iOffset % localBlockOffset + innerOffset +
                                iOffset / localBlockOffset * blockOffset;
                 outPtr[oOffset] = inPtr[iOffset];
             }
+            dimOffset += input.dims[dim];
         }
     }
 
-    void compute(const Operator &_op,
-                 const RuntimeObj *context) const override {
+    void lower(const Operator &_op, OpRecord &record) const override {
+        record.attrs.concat.axis = as<ConcatObj>(_op)->getDim();
+    }
+
+    KernelFunc resolve(const OpRecord &record) const override {
 #define CASE(N)                                                                \
     case N:                                                                    \
-        doCompute<DT<N>::t>(_op, context)
+        return doCompute<DT<N>::t>
 
-        int dataTypeIdx = _op->getDType().getIndex();
+        int dataTypeIdx = record.dtype.getIndex();
         switch (dataTypeIdx) {
             CASE(1); // DataType::Float32
-            break;
             CASE(12); // DataType::UInt32
-            break;
         default:
-            IT_TODO_HALT();
+            return nullptr;
         }
     }
 };
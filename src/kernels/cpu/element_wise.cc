@@ -1,113 +1,128 @@
 #include "operators/element_wise.h"
 #include "core/kernel.h"
+#include "core/plan.h"
 #include "utils/operator_utils.h"
 
 namespace infini
 {
     class NativeElementWise : public CpuKernelWithoutConfig
     {
-        template <typename T>
-        static T addCompute(T val0, T val1)
+        struct AddCompute
         {
-            return val0 + val1;
-        }
+            template <typename T>
+            static T apply(T val0, T val1) { return val0 + val1; }
+        };
 
-        template <typename T>
-        static T subCompute(T val0, T val1)
+        struct SubCompute
         {
-            return val0 - val1;
-        }
+            template <typename T>
+            static T apply(T val0, T val1) { return val0 - val1; }
+        };
 
-        template <typename T>
-        static T mulCompute(T val0, T val1)
+        struct MulCompute
         {
-            return val0 * val1;
-        }
+            template <typename T>
+            static T apply(T val0, T val1) { return val0 * val1; }
+        };
 
-        template <typename T>
-        static T divCompute(T val0, T val1)
+        struct DivCompute
         {
-            return (T)(val0 / val1);
-        }
+            template <typename T>
+            static T apply(T val0, T val1) { return (T)(val0 / val1); }
+        };
 
-        template <typename T>
-        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        // Walks the output in row-major order. The innermost dimension is a
+        // plain strided loop; outer dimensions advance an index counter so no
+        // division is needed per element.
+        template <typename T, typename F>
+        static void loop(const OpRecord &record, const RuntimeObj *context)
         {
-            auto op = as<ElementWiseObj>(_op);
-            T *inptr0 = op->getInputs(0)->getRawDataPtr<T *>();
-            T *inptr1 = op->getInputs(1)->getRawDataPtr<T *>();
-            T *outptr = op->getOutput()->getRawDataPtr<T *>();
+            const auto &output = record.outputs[0];
+            const T *inptr0 = record.inputs[0].getPtr<T *>();
+            const T *inptr1 = record.inputs[1].getPtr<T *>();
+            T *outptr = output.getPtr<T *>();
+            const size_t *strideA = record.attrs.elementWise.strides[0];
+            const size_t *strideB = record.attrs.elementWise.strides[1];
 
-            auto shapeA = op->getInputs(0)->getDims();
-            auto shapeB = op->getInputs(1)->getDims();
-            auto shapeC = op->getOutput()->getDims();
-            auto rank = op->getOutput()->getRank();
-            Shape a(rank, 1);
-            Shape b(rank, 1);
-            std::copy(shapeA.begin(), shapeA.end(),
-                      a.begin() + (rank - shapeA.size()));
-            std::copy(shapeB.begin(), shapeB.end(),
-                      b.begin() + (rank - shapeB.size()));
-            auto getStride = [&](const Shape &shape)
+            int rank = output.rank;
+            if (rank == 0 || output.size == 0)
+            {
+                if (output.size)
+                    outptr[0] = F::apply(inptr0[0], inptr1[0]);
+                return;
+            }
+            const size_t inner = output.dims[rank - 1];
+            const size_t sa = strideA[rank - 1], sb = strideB[rank - 1];
+            size_t index[MaxPlanRank] = {0};
+            size_t offsetA = 0, offsetB = 0;
+            for (size_t i = 0; i < output.size; i += inner)
             {
-                int p = 1;
-                Shape stride(rank);
-                for (auto i = rank; i > 0; --i)
+                T *out = outptr + i;
+                const T *a = inptr0 + offsetA, *b = inptr1 + offsetB;
+                if (sa == 1 && sb == 1)
+                    for (size_t j = 0; j < inner; ++j)
+                        out[j] = F::apply(a[j], b[j]);
+                else if (sb == 0)
+                    for (size_t j = 0; j < inner; ++j)
+                        out[j] = F::apply(a[j * sa], b[0]);
+                else
+                    for (size_t j = 0; j < inner; ++j)
+                        out[j] = F::apply(a[j * sa], b[j * sb]);
+
+                for (int d = rank - 2; d >= 0; --d)
                 {
-                    stride[i - 1] = p;
-                    p = p * shape[i - 1];
+                    offsetA += strideA[d];
+                    offsetB += strideB[d];
+                    if (++index[d] < (size_t)output.dims[d])
+                        break;
+                    offsetA -= strideA[d] * output.dims[d];
+                    offsetB -= strideB[d] * output.dims[d];
+                    index[d] = 0;
                 }
-                return stride;
-            };
-            Shape strideA = getStride(a);
-            Shape strideB = getStride(b);
+            }
+        }
 
-            auto n = op->getOutput()->size();
-            T (*_doCompute)
-            (T val0, T val1);
-            switch (op->getOpType().underlying())
+        template <typename T>
+        static KernelFunc select(OpType::underlying_t opType)
+        {
+            switch (opType)
             {
             case OpType::Add:
-                _doCompute = addCompute<T>;
-                break;
+                return loop<T, AddCompute>;
             case OpType::Sub:
-                _doCompute = subCompute<T>;
-                break;
+                return loop<T, SubCompute>;
             case OpType::Mul:
-                _doCompute = mulCompute<T>;
-                break;
+                return loop<T, MulCompute>;
             case OpType::Div:
-                _doCompute = divCompute<T>;
-                break;
+                return loop<T, DivCompute>;
             default:
                 IT_TODO_HALT();
             }
+        }
 
-            for (size_t i = 0; i < n; ++i)
-            {
-                auto shapeIndexC = locate_index(i, shapeC);
-                auto indexA = delocate_index(shapeIndexC, a, strideA);
-                auto indexB = delocate_index(shapeIndexC, b, strideB);
-                outptr[i] = _doCompute(inptr0[indexA], inptr1[indexB]);
-            }
+    public:
+        bool supportsStridedInputs() const override { return true; }
+
+        void lower(const Operator &_op, OpRecord &record) const override
+        {
+            for (int i = 0; i < 2; ++i)
+                broadcastStrides(record.inputs[i], record.outputs[0],
+                                 record.attrs.elementWise.strides[i]);
         }
 
-        void compute(const Operator &_op,
-                     const RuntimeObj *context) const override
+        KernelFunc resolve(const OpRecord &record) const override
         {
 #define CASE(N) \
     case N:     \
-        doCompute<DT<N>::t>(_op, context)
+        return select<DT<N>::t>(record.opType)
 
-            int dataTypeIdx = _op->getDType().getIndex();
+            int dataTypeIdx = record.dtype.getIndex();
             switch (dataTypeIdx)
             {
                 CASE(1); // DataType::Float32
-                break;
                 CASE(12); // DataType::UInt32
-                break;
             default:
-                IT_TODO_HALT();
+                return nullptr;
             }
         }
     };
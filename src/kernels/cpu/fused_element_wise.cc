@@ -0,0 +1,169 @@
+#include "operators/fused_element_wise.h"
+#include "core/kernel.h"
+#include "core/plan.h"
+
+namespace infini
+{
+    /**
+     * @brief Interprets the fused program over blocks of the output. Each
+     * step runs over a whole block so the interpreter overhead is paid once
+     * per block and every step is a simple loop the compiler can vectorize.
+     * Inputs are read once and the output is written once; intermediates
+     * only live in the block-sized stack.
+     */
+    class NativeFusedElementWise : public CpuKernelWithoutConfig
+    {
+        static constexpr size_t Block = 256;
+        using Stride = size_t[MaxPlanRank];
+
+        template <typename T>
+        static void load(T *dst, const T *src, size_t stride, size_t n)
+        {
+            if (stride == 1)
+                std::copy(src, src + n, dst);
+            else if (stride == 0)
+                std::fill(dst, dst + n, src[0]);
+            else
+                for (size_t j = 0; j < n; ++j)
+                    dst[j] = src[j * stride];
+        }
+
+        template <typename T>
+        static void apply(const FusedStep &step, T *lhs, const T *rhs,
+                          size_t n)
+        {
+            switch (step.opType)
+            {
+            case OpType::Add:
+                for (size_t j = 0; j < n; ++j)
+                    lhs[j] = lhs[j] + rhs[j];
+                break;
+            case OpType::Sub:
+                for (size_t j = 0; j < n; ++j)
+                    lhs[j] = lhs[j] - rhs[j];
+                break;
+            case OpType::Mul:
+                for (size_t j = 0; j < n; ++j)
+                    lhs[j] = lhs[j] * rhs[j];
+                break;
+            case OpType::Div:
+                for (size_t j = 0; j < n; ++j)
+                    lhs[j] = (T)(lhs[j] / rhs[j]);
+                break;
+            case OpType::Relu:
+                for (size_t j = 0; j < n; ++j)
+                    lhs[j] = std::max(T(0), lhs[j]);
+                break;
+            case OpType::Clip:
+                for (size_t j = 0; j < n; ++j)
+                {
+                    T val = lhs[j];
+                    lhs[j] = (step.hasMin && val < step.min)   ? step.min
+                             : (step.hasMax && val > step.max) ? step.max
+                                                               : val;
+                }
+                break;
+            default:
+                IT_TODO_HALT();
+            }
+        }
+
+        template <typename T>
+        static void doCompute(const OpRecord &record, const RuntimeObj *context)
+        {
+            const auto &output = record.outputs[0];
+            const FusedStep *program = record.attrs.fused.program;
+            const int length = record.attrs.fused.length;
+            const int numInputs = record.numInputs;
+            if (output.size == 0)
+                return;
+
+            Stride stride[FusedElementWiseObj::MaxInputs];
+            const T *inptr[FusedElementWiseObj::MaxInputs];
+            size_t offset[FusedElementWiseObj::MaxInputs] = {0};
+            size_t innerStride[FusedElementWiseObj::MaxInputs];
+            const int rank = output.rank;
+            for (int i = 0; i < numInputs; ++i)
+            {
+                broadcastStrides(record.inputs[i], output, stride[i]);
+                inptr[i] = record.inputs[i].getPtr<T *>();
+                innerStride[i] = rank ? stride[i][rank - 1] : 0;
+            }
+            T *outptr = output.getPtr<T *>();
+
+            T stack[FusedElementWiseObj::MaxStackDepth][Block];
+            const size_t inner = rank ? output.dims[rank - 1] : 1;
+            size_t index[MaxPlanRank] = {0};
+            for (size_t row = 0; row < output.size; row += inner)
+            {
+                for (size_t j0 = 0; j0 < inner; j0 += Block)
+                {
+                    const size_t n = std::min(Block, inner - j0);
+                    int top = -1;
+                    for (int s = 0; s < length; ++s)
+                    {
+                        const auto &step = program[s];
+                        if (step.input >= 0)
+                        {
+                            int i = step.input;
+                            load(stack[++top],
+                                 inptr[i] + offset[i] + j0 * innerStride[i],
+                                 innerStride[i], n);
+                        }
+                        else if (step.opType == OpType::Relu ||
+                                 step.opType == OpType::Clip)
+                            apply(step, stack[top], stack[top], n);
+                        else
+                        {
+                            --top;
+                            apply(step, stack[top], stack[top + 1], n);
+                        }
+                    }
+                    std::copy(stack[0], stack[0] + n, outptr + row + j0);
+                }
+
+                for (int d = rank - 2; d >= 0; --d)
+                {
+                    for (int i = 0; i < numInputs; ++i)
+                        offset[i] += stride[i][d];
+                    if (++index[d] < (size_t)output.dims[d])
+                        break;
+                    for (int i = 0; i < numInputs; ++i)
+                        offset[i] -= stride[i][d] * output.dims[d];
+                    index[d] = 0;
+                }
+            }
+        }
+
+    public:
+        bool supportsStridedInputs() const override { return true; }
+
+        void lower(const Operator &_op, OpRecord &record) const override
+        {
+            const auto &program = as<FusedElementWiseObj>(_op)->getProgram();
+            record.attrs.fused.program = program.data();
+            record.attrs.fused.length = program.size();
+        }
+
+        KernelFunc resolve(const OpRecord &record) const override
+        {
+#define CASE(N) \
+    case N:     \
+        return doCompute<DT<N>::t>
+
+            int dataTypeIdx = record.dtype.getIndex();
+            switch (dataTypeIdx)
+            {
+                CASE(1); // DataType::Float32
+                CASE(12); // DataType::UInt32
+            default:
+                return nullptr;
+            }
+#undef CASE
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::FusedElementWise,
+                    NativeFusedElementWise, "FusedElementWise_CPU");
+
+}; // namespace infini
@@ -0,0 +1,324 @@
+#include "operators/matmul.h"
+#include "core/kernel.h"
+
+namespace infini
+{
+    /**
+     * @brief Batch handling shared by the matmul candidates. `Gemm` computes
+     * one [m, k] x [k, n] product into a contiguous [m, n] output.
+     */
+    class MatmulBase : public CpuKernelWithoutConfig
+    {
+    protected:
+        template <typename T, void (*Gemm)(const T *, const T *, T *,
+                                           const OpRecord &)>
+        static void forEachBatch(const OpRecord &record,
+                                 const RuntimeObj *context)
+        {
+            const auto &attrs = record.attrs.matmul;
+            const auto &output = record.outputs[0];
+            const T *A = record.inputs[0].getPtr<T *>();
+            const T *B = record.inputs[1].getPtr<T *>();
+            T *C = output.getPtr<T *>();
+            const size_t matrix = (size_t)attrs.m * attrs.n;
+            const int batchRank = output.rank - 2;
+            const size_t *strideA = attrs.batchStrides[0];
+            const size_t *strideB = attrs.batchStrides[1];
+            if (matrix == 0)
+                return;
+
+            size_t index[MaxPlanRank] = {0};
+            size_t offsetA = 0, offsetB = 0;
+            for (size_t offsetC = 0; offsetC < output.size; offsetC += matrix)
+            {
+                Gemm(A + offsetA, B + offsetB, C + offsetC, record);
+                for (int d = batchRank - 1; d >= 0; --d)
+                {
+                    offsetA += strideA[d];
+                    offsetB += strideB[d];
+                    if (++index[d] < (size_t)output.dims[d])
+                        break;
+                    offsetA -= strideA[d] * output.dims[d];
+                    offsetB -= strideB[d] * output.dims[d];
+                    index[d] = 0;
+                }
+            }
+        }
+
+        // Adds the bias and applies the clamp to columns [j0, j0 + nc) of one
+        // row of C, while that row is still in cache.
+        template <typename T>
+        static void epilogue(T *c, int j0, int nc, const OpRecord &record)
+        {
+            const auto &attrs = record.attrs.matmul;
+            if (attrs.hasBias)
+            {
+                const T *bias = record.inputs[2].getPtr<T *>();
+                const size_t stride = attrs.biasStride;
+                for (int j = 0; j < nc; ++j)
+                    c[j] += bias[(j0 + j) * stride];
+            }
+            if (attrs.hasMin || attrs.hasMax)
+                for (int j = 0; j < nc; ++j)
+                {
+                    T val = c[j];
+                    c[j] = (attrs.hasMin && val < attrs.min)   ? attrs.min
+                           : (attrs.hasMax && val > attrs.max) ? attrs.max
+                                                               : val;
+                }
+        }
+
+        // Element (i, p) of A and (p, j) of B honoring transA/transB.
+        template <typename T>
+        static T loadA(const T *A, int i, int p, const OpRecord &record)
+        {
+            const auto &attrs = record.attrs.matmul;
+            return attrs.transA ? A[(size_t)p * attrs.m + i]
+                                : A[(size_t)i * attrs.k + p];
+        }
+
+        template <typename T>
+        static T loadB(const T *B, int p, int j, const OpRecord &record)
+        {
+            const auto &attrs = record.attrs.matmul;
+            if (int block = record.inputs[1].block)
+                return B[((size_t)(j / block) * attrs.k + p) * block +
+                         j % block];
+            return attrs.transB ? B[(size_t)j * attrs.k + p]
+                                : B[(size_t)p * attrs.n + j];
+        }
+
+    public:
+        // B may be blocked; A, the bias and C are always plain.
+        bool supportsBlockedLayouts() const override { return true; }
+
+        void lower(const Operator &_op, OpRecord &record) const override
+        {
+            auto op = as<MatmulObj>(_op);
+            auto &attrs = record.attrs.matmul;
+            for (int i = 0; i < record.numInputs; ++i)
+                IT_ASSERT(i == 1 || !record.inputs[i].block);
+            IT_ASSERT(!record.outputs[0].block);
+            IT_ASSERT(!record.inputs[1].block ||
+                          (record.inputs[1].rank == 2 && !op->getTransB()),
+                      "A blocked B must be a single untransposed matrix");
+            attrs.transA = op->getTransA();
+            attrs.transB = op->getTransB();
+            attrs.m = op->getM();
+            attrs.n = op->getN();
+            attrs.k = op->getK();
+            attrs.hasBias = op->hasBias();
+            attrs.biasStride =
+                op->hasBias() && op->getBias()->size() > 1 ? 1 : 0;
+            attrs.hasMin = op->getClampMin().has_value();
+            attrs.hasMax = op->getClampMax().has_value();
+            attrs.min = op->getClampMin().value_or(0.f);
+            attrs.max = op->getClampMax().value_or(0.f);
+            const auto &output = record.outputs[0];
+            int batchRank = output.rank - 2;
+            for (int i = 0; i < 2; ++i)
+            {
+                const auto &input = record.inputs[i];
+                int shift = output.rank - input.rank;
+                for (int d = 0; d < MaxPlanRank; ++d)
+                {
+                    int id = d - shift;
+                    attrs.batchStrides[i][d] =
+                        (d < batchRank && id >= 0 && input.dims[id] != 1)
+                            ? input.strides[id]
+                            : 0;
+                }
+            }
+        }
+    };
+
+    class NaiveMatmul : public MatmulBase
+    {
+        template <typename T>
+        static void gemm(const T *A, const T *B, T *C, const OpRecord &record)
+        {
+            const auto &attrs = record.attrs.matmul;
+            for (int i = 0; i < attrs.m; ++i)
+            {
+                T *c = C + (size_t)i * attrs.n;
+                for (int j = 0; j < attrs.n; ++j)
+                {
+                    T acc = 0;
+                    for (int p = 0; p < attrs.k; ++p)
+                        acc += loadA(A, i, p, record) * loadB(B, p, j, record);
+                    c[j] = acc;
+                }
+                epilogue(c, 0, attrs.n, record);
+            }
+        }
+
+    public:
+        KernelFunc resolve(const OpRecord &record) const override
+        {
+#define CASE(N) \
+    case N:     \
+        return forEachBatch<DT<N>::t, gemm<DT<N>::t>>
+
+            int dataTypeIdx = record.dtype.getIndex();
+            switch (dataTypeIdx)
+            {
+                CASE(1); // DataType::Float32
+                CASE(12); // DataType::UInt32
+            default:
+                return nullptr;
+            }
+#undef CASE
+        }
+    };
+
+    /**
+     * @brief Cache-blocked matmul. A [KC, NC] panel of B is packed into a
+     * contiguous stack buffer, then every row of A is streamed against it
+     * with a unit-stride inner loop over the columns of C. The epilogue runs
+     * on each row of the panel right after its last update.
+     */
+    template <int NC, int KC>
+    class BlockedMatmul : public MatmulBase
+    {
+        template <typename T>
+        static void gemm(const T *A, const T *B, T *C, const OpRecord &record)
+        {
+            const auto &attrs = record.attrs.matmul;
+            const int m = attrs.m, n = attrs.n, k = attrs.k;
+            std::fill(C, C + (size_t)m * n, T(0));
+            T packed[KC * NC];
+            for (int jc = 0; jc < n; jc += NC)
+            {
+                const int nc = std::min(NC, n - jc);
+                for (int pc = 0; pc < k; pc += KC)
+                {
+                    const int kc = std::min(KC, k - pc);
+                    for (int p = 0; p < kc; ++p)
+                        for (int j = 0; j < nc; ++j)
+                            packed[p * nc + j] =
+                                loadB(B, pc + p, jc + j, record);
+                    const bool last = pc + kc == k;
+                    for (int i = 0; i < m; ++i)
+                    {
+                        T *c = C + (size_t)i * n + jc;
+                        for (int p = 0; p < kc; ++p)
+                        {
+                            const T a = loadA(A, i, pc + p, record);
+                            const T *b = packed + p * nc;
+                            for (int j = 0; j < nc; ++j)
+                                c[j] += a * b[j];
+                        }
+                        if (last)
+                            epilogue(c, jc, nc, record);
+                    }
+                }
+            }
+            if (k == 0)
+                for (int i = 0; i < m; ++i)
+                    epilogue(C + (size_t)i * n, 0, n, record);
+        }
+
+    public:
+        KernelFunc resolve(const OpRecord &record) const override
+        {
+#define CASE(N) \
+    case N:     \
+        return MatmulBase::forEachBatch<DT<N>::t, gemm<DT<N>::t>>
+
+            int dataTypeIdx = record.dtype.getIndex();
+            switch (dataTypeIdx)
+            {
+                CASE(1); // DataType::Float32
+                CASE(12); // DataType::UInt32
+            default:
+                return nullptr;
+            }
+#undef CASE
+        }
+    };
+
+    using BlockedMatmul64x256 = BlockedMatmul<64, 256>;
+    using BlockedMatmul256x64 = BlockedMatmul<256, 64>;
+
+    /**
+     * @brief Matmul with a B operand that is already packed into panels by
+     * a blocked layout. Every row of A is multiplied with one panel at a
+     * time into W accumulators, which the compiler keeps in vector
+     * registers, so there is no packing at run time. A plain B falls back
+     * to the cache-blocked kernel.
+     */
+    class PackedMatmul : public BlockedMatmul64x256
+    {
+        template <typename T, int W>
+        static void gemm(const T *A, const T *B, T *C, const OpRecord &record)
+        {
+            const auto &attrs = record.attrs.matmul;
+            const int m = attrs.m, n = attrs.n, k = attrs.k;
+            for (int j0 = 0; j0 < n; j0 += W)
+            {
+                const T *panel = B + (size_t)j0 * k;
+                const int nc = std::min(W, n - j0);
+                for (int i = 0; i < m; ++i)
+                {
+                    T acc[W] = {0};
+                    for (int p = 0; p < k; ++p)
+                    {
+                        const T a = loadA(A, i, p, record);
+                        const T *b = panel + (size_t)p * W;
+                        for (int l = 0; l < W; ++l)
+                            acc[l] += a * b[l];
+                    }
+                    T *c = C + (size_t)i * n + j0;
+                    std::copy(acc, acc + nc, c);
+                    epilogue(c, j0, nc, record);
+                }
+            }
+        }
+
+        template <typename T>
+        static KernelFunc select(int block)
+        {
+            switch (block)
+            {
+            case 8:
+                return MatmulBase::forEachBatch<T, gemm<T, 8>>;
+            case 16:
+                return MatmulBase::forEachBatch<T, gemm<T, 16>>;
+            default:
+                IT_TODO_HALT_MSG("Unsupported block " + std::to_string(block));
+            }
+        }
+
+    public:
+        KernelFunc resolve(const OpRecord &record) const override
+        {
+            int block = record.inputs[1].block;
+            if (!block)
+                return BlockedMatmul64x256::resolve(record);
+#define CASE(N) \
+    case N:     \
+        return select<DT<N>::t>(block)
+
+            int dataTypeIdx = record.dtype.getIndex();
+            switch (dataTypeIdx)
+            {
+                CASE(1); // DataType::Float32
+                CASE(12); // DataType::UInt32
+            default:
+                return nullptr;
+            }
+#undef CASE
+        }
+    };
+
+    // The packed kernel is the default, so that blocked operands chosen by
+    // GraphObj::chooseLayouts are used without the autotuner.
+    REGISTER_KERNEL(Device::CPU, OpType::MatMul, PackedMatmul,
+                    "MatmulPacked_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::MatMul, BlockedMatmul64x256,
+                    "MatmulBlocked64x256_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::MatMul, BlockedMatmul256x64,
+                    "MatmulBlocked256x64_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::MatMul, NaiveMatmul, "MatmulNaive_CPU");
+
+}; // namespace infini
@@ -0,0 +1,82 @@
+#include "operators/reorder.h"
+#include "core/kernel.h"
+
+namespace infini
+{
+    /**
+     * @brief Copies between plain and blocked layouts, see
+     * TensorObj::getBlock. Elements are moved as raw bits, so one
+     * instantiation per element size serves every data type.
+     */
+    class NativeReorder : public CpuKernelWithoutConfig
+    {
+        // Offset of element (row, col) of matrix `outer` in a tensor with
+        // `rows` x `cols` matrices.
+        static size_t offset(int block, size_t outer, size_t row, size_t col,
+                             size_t rows, size_t cols)
+        {
+            if (!block)
+                return (outer * rows + row) * cols + col;
+            size_t blocks = (cols + block - 1) / block;
+            return ((outer * blocks + col / block) * rows + row) * block +
+                   col % block;
+        }
+
+        template <typename T>
+        static void doCompute(const OpRecord &record, const RuntimeObj *context)
+        {
+            const auto &input = record.inputs[0], &output = record.outputs[0];
+            const T *in = input.getPtr<T *>();
+            T *out = output.getPtr<T *>();
+            const int rank = output.rank;
+            if (rank == 0)
+            {
+                if (output.size)
+                    out[0] = in[0];
+                return;
+            }
+            const size_t cols = output.dims[rank - 1];
+            const size_t rows = rank > 1 ? output.dims[rank - 2] : 1;
+            if (cols == 0 || rows == 0)
+                return;
+            const size_t matrices = output.size / (rows * cols);
+            if (output.block)
+            {
+                // Zero the padding of the last block.
+                size_t blocks = (cols + output.block - 1) / output.block;
+                std::fill(out, out + matrices * blocks * rows * output.block,
+                          T(0));
+            }
+            for (size_t m = 0; m < matrices; ++m)
+                for (size_t r = 0; r < rows; ++r)
+                    for (size_t c = 0; c < cols; ++c)
+                        out[offset(output.block, m, r, c, rows, cols)] =
+                            in[offset(input.block, m, r, c, rows, cols)];
+        }
+
+    public:
+        bool supportsBlockedLayouts() const override { return true; }
+
+        KernelFunc resolve(const OpRecord &record) const override
+        {
+            IT_ASSERT(record.inputs[0].dtype == record.outputs[0].dtype);
+            switch (record.dtype.getSize())
+            {
+            case 1:
+                return doCompute<uint8_t>;
+            case 2:
+                return doCompute<uint16_t>;
+            case 4:
+                return doCompute<uint32_t>;
+            case 8:
+                return doCompute<uint64_t>;
+            default:
+                return nullptr;
+            }
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::Reorder, NativeReorder,
+                    "Reorder_CPU");
+
+}; // namespace infini
@@ -3,58 +3,155 @@
 
 namespace infini {
 
-inline Shape idx2Pos(const Shape &shape, size_t idx) {
-    Shape pos = Shape(shape.size(), 0);
-    auto rest = idx, curDimId = shape.size() - 1;
-    while (rest > 0) {
-        pos[curDimId] = rest % shape[curDimId];
-        rest /= shape[curDimId];
-        curDimId--;
+class NaiveTranspose : public CpuKernelWithoutConfig {
+    template <typename T>
+    static void doCompute(const OpRecord &record, const RuntimeObj *context) {
+        const auto &input = record.inputs[0], &output = record.outputs[0];
+        const auto *perm = record.attrs.transpose.permute;
+        int rank = output.rank;
+
+        auto inPtr = input.getPtr<T *>(), outPtr = output.getPtr<T *>();
+        if (rank == 0) {
+            if (output.size)
+                outPtr[0] = inPtr[0];
+            return;
+        }
+        // Walk the output contiguously and gather from the input through the
+        // permuted input strides.
+        size_t inStride[MaxPlanRank];
+        for (int j = 0; j < rank; ++j)
+            inStride[j] = input.strides[perm[j]];
+        const size_t inner = output.dims[rank - 1];
+        const size_t innerStride = inStride[rank - 1];
+        size_t index[MaxPlanRank] = {0};
+        size_t inOffset = 0;
+        for (size_t outIdx = 0; outIdx < output.size; outIdx += inner) {
+            const T *in = inPtr + inOffset;
+            T *out = outPtr + outIdx;
+            for (size_t j = 0; j < inner; ++j)
+                out[j] = in[j * innerStride];
+            for (int d = rank - 2; d >= 0; --d) {
+                inOffset += inStride[d];
+                if (++index[d] < (size_t)output.dims[d])
+                    break;
+                inOffset -= inStride[d] * output.dims[d];
+                index[d] = 0;
+            }
+        }
     }
-    return pos;
-}
 
-class NaiveTranspose : public CpuKernelWithoutConfig {
+  public:
+    bool supportsStridedInputs() const override { return true; }
+
+    void lower(const Operator &_op, OpRecord &record) const override {
+        const auto &perm = as<TransposeObj>(_op)->getPermute();
+        for (size_t i = 0; i < perm.size(); ++i)
+            record.attrs.transpose.permute[i] = perm[i];
+    }
+
+    KernelFunc resolve(const OpRecord &record) const override {
+#define CASE(N)                                                                \
+    case N:                                                                    \
+        return doCompute<DT<N>::t>
+
+        int dataTypeIdx = record.dtype.getIndex();
+        switch (dataTypeIdx) {
+            CASE(1); // DataType::Float32
+            CASE(12); // DataType::UInt32
+        default:
+            return nullptr;
+        }
+#undef CASE
+    }
+};
+
+/**
+ * @brief Copies square tiles between the contiguous axis of the output and
+ * the output axis that reads the contiguous axis of the input, so that both
+ * sides are accessed in cache-line sized runs. Permutations that keep the
+ * last axis in place are already contiguous on both sides and use the naive
+ * kernel.
+ */
+class TiledTranspose : public NaiveTranspose {
+    static constexpr int Tile = 32;
+
     template <typename T>
-    void doCompute(const Operator &_op, const RuntimeObj *context) const {
-        auto op = as<TransposeObj>(_op);
-        auto inputs = op->getInputs(), outputs = op->getOutputs();
-        const auto &inDim = inputs[0]->getDims();
-        const auto &perm = op->getPermute();
-
-        size_t inSize = inputs[0]->size();
-        auto inPtr = inputs[0]->getRawDataPtr<T *>(),
-             outPtr = outputs[0]->getRawDataPtr<T *>();
-        // #pragma omp parallel for
-        for (size_t inIdx = 0; inIdx < inSize; ++inIdx) {
-            auto posInput = idx2Pos(inDim, inIdx);
-            int outIdx = 0;
-            for (size_t j = 0, jEnd = perm.size(); j < jEnd; ++j) {
-                outIdx = outIdx * inDim[perm[j]] + posInput[perm[j]];
+    static void doCompute(const OpRecord &record, const RuntimeObj *context) {
+        const auto &input = record.inputs[0], &output = record.outputs[0];
+        const auto *perm = record.attrs.transpose.permute;
+        int rank = output.rank;
+        int rowAxis = 0;
+        while (perm[rowAxis] != rank - 1)
+            ++rowAxis;
+
+        size_t inStride[MaxPlanRank];
+        for (int j = 0; j < rank; ++j)
+            inStride[j] = input.strides[perm[j]];
+        const size_t rows = output.dims[rowAxis], cols = output.dims[rank - 1];
+        const size_t outRowStride = output.strides[rowAxis];
+        const size_t inRowStride = inStride[rowAxis];
+        const size_t inColStride = inStride[rank - 1];
+
+        // Remaining output axes are walked with an index counter.
+        int outer[MaxPlanRank], numOuter = 0;
+        for (int j = 0; j < rank - 1; ++j)
+            if (j != rowAxis)
+                outer[numOuter++] = j;
+        size_t index[MaxPlanRank] = {0};
+        size_t inBase = 0, outBase = 0;
+        size_t planeSize = rows * cols;
+        size_t numPlanes = planeSize ? output.size / planeSize : 0;
+
+        auto inPtr = input.getPtr<T *>(), outPtr = output.getPtr<T *>();
+        for (size_t plane = 0; plane < numPlanes; ++plane) {
+            for (size_t i0 = 0; i0 < rows; i0 += Tile) {
+                size_t iEnd = std::min(rows, i0 + Tile);
+                for (size_t j0 = 0; j0 < cols; j0 += Tile) {
+                    size_t jEnd = std::min(cols, j0 + Tile);
+                    for (size_t i = i0; i < iEnd; ++i) {
+                        T *out = outPtr + outBase + i * outRowStride;
+                        const T *in = inPtr + inBase + i * inRowStride;
+                        for (size_t j = j0; j < jEnd; ++j)
+                            out[j] = in[j * inColStride];
+                    }
+                }
+            }
+            for (int d = numOuter - 1; d >= 0; --d) {
+                int axis = outer[d];
+                inBase += inStride[axis];
+                outBase += output.strides[axis];
+                if (++index[d] < (size_t)output.dims[axis])
+                    break;
+                inBase -= inStride[axis] * output.dims[axis];
+                outBase -= output.strides[axis] * output.dims[axis];
+                index[d] = 0;
             }
-            outPtr[outIdx] = inPtr[inIdx];
         }
     }
 
-    void compute(const Operator &_op,
-                 const RuntimeObj *context) const override {
+  public:
+    KernelFunc resolve(const OpRecord &record) const override {
+        int rank = record.outputs[0].rank;
+        if (rank < 2 || record.attrs.transpose.permute[rank - 1] == rank - 1)
+            return NaiveTranspose::resolve(record);
 #define CASE(N)                                                                \
     case N:                                                                    \
-        doCompute<DT<N>::t>(_op, context)
+        return doCompute<DT<N>::t>
 
-        int dataTypeIdx = _op->getDType().getIndex();
+        int dataTypeIdx = record.dtype.getIndex();
         switch (dataTypeIdx) {
             CASE(1); // DataType::Float32
-            break;
             CASE(12); // DataType::UInt32
-            break;
         default:
-            IT_TODO_HALT();
+            return nullptr;
         }
+#undef CASE
     }
 };
 
 REGISTER_KERNEL(Device::CPU, OpType::Transpose, NaiveTranspose,
                 "TransposeNaive_CPU");
+REGISTER_KERNEL(Device::CPU, OpType::Transpose, TiledTranspose,
+                "TransposeTiled_CPU");
 
 } // namespace infini
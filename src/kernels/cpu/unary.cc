@@ -11,90 +11,90 @@ namespace infini
             return std::max(T(0), val);
         }
 
-        template <typename T>
-        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        template <typename T, T (*F)(T)>
+        static void doCompute(const OpRecord &record, const RuntimeObj *context)
         {
-            auto op = as<UnaryObj>(_op);
-            T *inptr = op->getInputs(0)->getRawDataPtr<T *>();
-            T *outptr = op->getOutput()->getRawDataPtr<T *>();
+            T *inptr = record.inputs[0].getPtr<T *>();
+            T *outptr = record.outputs[0].getPtr<T *>();
+            auto n = record.outputs[0].size;
 
-            auto outDim = op->getOutput()->getDims();
-            auto n = op->getOutput()->size();
+            for (size_t offset = 0; offset < n; offset++)
+                outptr[offset] = F(inptr[offset]);
+        }
 
-            T (*_doCompute)
-            (T val);
-            switch (op->getOpType().underlying())
+        template <typename T>
+        static KernelFunc select(OpType::underlying_t opType)
+        {
+            switch (opType)
             {
             case OpType::Relu:
-                _doCompute = reluCompute<T>;
-                break;
+                return doCompute<T, reluCompute<T>>;
             default:
                 IT_TODO_HALT();
             }
-
-            for (size_t offset = 0; offset < n; offset++)
-            {
-                outptr[offset] = _doCompute(inptr[offset]);
-            }
         }
 
-        void compute(const Operator &_op,
-                     const RuntimeObj *context) const override
+        KernelFunc resolve(const OpRecord &record) const override
         {
 #define CASE(N) \
     case N:     \
-        doCompute<DT<N>::t>(_op, context)
+        return select<DT<N>::t>(record.opType)
 
-            int dataTypeIdx = _op->getDType().getIndex();
+            int dataTypeIdx = record.dtype.getIndex();
             switch (dataTypeIdx)
             {
                 CASE(1); // DataType::Float32
-                break;
                 CASE(12); // DataType::UInt32
-                break;
             default:
-                IT_TODO_HALT();
+                return nullptr;
             }
+#undef CASE
         }
     };
 
     class Clip : public CpuKernelWithoutConfig
     {
         template <typename T>
-        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        static void doCompute(const OpRecord &record, const RuntimeObj *context)
         {
-            auto op = as<ClipObj>(_op);
-            T *inptr = op->getInputs(0)->getRawDataPtr<T *>();
-            T *outptr = op->getOutput()->getRawDataPtr<T *>();
-            auto minValue = op->getMin();
-            auto maxValue = op->getMax();
+            T *inptr = record.inputs[0].getPtr<T *>();
+            T *outptr = record.outputs[0].getPtr<T *>();
+            const auto &clip = record.attrs.clip;
 
-            auto n = op->getOutput()->size();
+            auto n = record.outputs[0].size;
             for (size_t offset = 0; offset < n; offset++)
             {
                 auto val = *inptr++;
-                *outptr++ = (minValue && val < *minValue)   ? *minValue
-                            : (maxValue && val > *maxValue) ? *maxValue
-                                                            : val;
+                *outptr++ = (clip.hasMin && val < clip.min)   ? clip.min
+                            : (clip.hasMax && val > clip.max) ? clip.max
+                                                              : val;
             }
         }
 
-        void compute(const Operator &_op,
-                     const RuntimeObj *context) const override
+        void lower(const Operator &_op, OpRecord &record) const override
+        {
+            auto op = as<ClipObj>(_op);
+            auto minValue = op->getMin();
+            auto maxValue = op->getMax();
+            record.attrs.clip.hasMin = minValue.has_value();
+            record.attrs.clip.hasMax = maxValue.has_value();
+            record.attrs.clip.min = minValue.value_or(0.f);
+            record.attrs.clip.max = maxValue.value_or(0.f);
+        }
+
+        KernelFunc resolve(const OpRecord &record) const override
         {
 #define CASE(N) \
     case N:     \
-        doCompute<DT<N>::t>(_op, context)
+        return doCompute<DT<N>::t>
 
-            int dataTypeIdx = _op->getDType().getIndex();
+            int dataTypeIdx = record.dtype.getIndex();
             switch (dataTypeIdx)
             {
                 CASE(1); // DataType::Float32
-                break;
                 CASE(12); // DataType::UInt32
-                break;
             default:
-                IT_TODO_HALT();
+                return nullptr;
             }
         }
     };
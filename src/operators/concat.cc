@@ -45,4 +45,9 @@ namespace infini
         return os.str();
     }
 
+    vector<int> ConcatObj::getOpAttrVector() const
+    {
+        return {type.underlying(), dim};
+    }
+
 } // namespace infini
@@ -30,4 +30,9 @@ namespace infini
         return os.str();
     }
 
+    vector<int> ElementWiseObj::getOpAttrVector() const
+    {
+        return {type.underlying()};
+    }
+
 }; // namespace infini
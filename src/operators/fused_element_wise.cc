@@ -0,0 +1,102 @@
+#include "operators/fused_element_wise.h"
+#include "utils/operator_utils.h"
+
+namespace infini
+{
+    FusedElementWiseObj::FusedElementWiseObj(GraphObj *graph, TensorVec inputs,
+                                             Tensor output,
+                                             vector<FusedStep> program)
+        : OperatorObj(OpType::FusedElementWise, inputs, {output}),
+          program(std::move(program))
+    {
+        IT_ASSERT(!this->inputs.empty() &&
+                  (int)this->inputs.size() <= MaxInputs);
+        int depth = stackDepth(this->program);
+        IT_ASSERT(depth >= 1 && depth <= MaxStackDepth,
+                  "Invalid fused element-wise program");
+        IT_ASSERT(checkValid(graph));
+    }
+
+    optional<vector<Shape>> FusedElementWiseObj::inferShape(
+        const TensorVec &inputs)
+    {
+        Shape ret = inputs[0]->getDims();
+        for (size_t i = 1; i < inputs.size(); ++i)
+            ret = infer_broadcast(ret, inputs[i]->getDims());
+        return {{ret}};
+    }
+
+    std::string FusedElementWiseObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        for (const auto &step : program)
+        {
+            if (step.input >= 0)
+                os << "$" << step.input << " ";
+            else
+                os << OpType(step.opType).toString() << " ";
+        }
+        for (size_t i = 0; i < inputs.size(); ++i)
+            os << "input" << i << "=" << inputs[i]->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+
+    int64_t FusedElementWiseObj::getFlops() const
+    {
+        int64_t steps = 0;
+        for (const auto &step : program)
+            steps += step.input < 0;
+        return steps * outputs[0]->size();
+    }
+
+    vector<int> FusedElementWiseObj::getOpAttrVector() const
+    {
+        auto bits = [](float v)
+        {
+            int32_t ret;
+            std::memcpy(&ret, &v, sizeof(ret));
+            return ret;
+        };
+        vector<int> ret{type.underlying()};
+        for (const auto &step : program)
+        {
+            ret.insert(ret.end(), {step.opType, step.input, step.hasMin,
+                                   bits(step.min), step.hasMax, bits(step.max)});
+        }
+        return ret;
+    }
+
+    int FusedElementWiseObj::stackDepth(const vector<FusedStep> &program)
+    {
+        int depth = 0, maxDepth = 0;
+        for (const auto &step : program)
+        {
+            if (step.input >= 0)
+                maxDepth = std::max(maxDepth, ++depth);
+            else
+            {
+                switch (step.opType)
+                {
+                case OpType::Add:
+                case OpType::Sub:
+                case OpType::Mul:
+                case OpType::Div:
+                    --depth;
+                    break;
+                case OpType::Relu:
+                case OpType::Clip:
+                    break;
+                default:
+                    return -1;
+                }
+                if (depth < 1)
+                    return -1;
+            }
+        }
+        return depth == 1 ? maxDepth : -1;
+    }
+
+}; // namespace infini
@@ -4,11 +4,24 @@ namespace infini
 {
 
     MatmulObj::MatmulObj(GraphObj *graph, Tensor A, Tensor B, Tensor C, bool transA,
-                         bool transB)
-        : OperatorObj(OpType::MatMul, TensorVec{A, B}, {C}),
+                         bool transB, Tensor bias)
+        : OperatorObj(OpType::MatMul,
+                      bias ? TensorVec{A, B, bias} : TensorVec{A, B}, {C}),
           transA(transA), transB(transB)
     {
         IT_ASSERT(checkValid(graph));
+        IT_ASSERT(!bias || isValidBias(bias));
+    }
+
+    bool MatmulObj::isValidBias(const Tensor &bias) const
+    {
+        if (!(bias->getDType() == inputs[0]->getDType()))
+            return false;
+        if (bias->size() == 1)
+            return true;
+        const auto dims = bias->getDims();
+        return !dims.empty() && dims.back() == n && (int)bias->size() == n &&
+               dims.size() <= outputs[0]->getRank();
     }
 
     string MatmulObj::toString() const
@@ -17,7 +30,14 @@ namespace infini
         os << "Matmul([" << (transA ? "A^T" : "A") << "," << (transB ? "B^T" : "B]")
            << ",A=" << inputs[0]->getGuid()
            << ",B=" << inputs[1]->getGuid() << ",C=" << outputs[0]->getGuid()
-           << ",mnk=[" << m << "," << n << "," << k << "])";
+           << ",mnk=[" << m << "," << n << "," << k << "]";
+        if (hasBias())
+            os << ",bias=" << inputs[2]->getGuid();
+        if (clampMin)
+            os << ",min=" << *clampMin;
+        if (clampMax)
+            os << ",max=" << *clampMax;
+        os << ")";
         return os.str();
     }
 
@@ -46,7 +66,34 @@ namespace infini
         shape_A[A_rank - 1] = 1;
         shape_B[B_rank - 2] = 1;
         auto output_shape = infer_broadcast(shape_A, shape_B);
+        // shape_A is [..., m, 1] and shape_B is [..., 1, n] at this point
+        m = shape_A[A_rank - 2];
+        n = shape_B[B_rank - 1];
+        k = transA ? inputs[0]->getDims()[A_rank - 2]
+                   : inputs[0]->getDims()[A_rank - 1];
         return {{output_shape}};
     }
 
+    int64_t MatmulObj::getFlops() const
+    {
+        int64_t size = outputs[0]->size();
+        return 2 * size * k + (hasBias() ? size : 0) + (hasClamp() ? size : 0);
+    }
+
+    vector<int> MatmulObj::getOpAttrVector() const
+    {
+        // Clamp bounds are stored bitwise so that equal attributes compare
+        // equal.
+        auto bits = [](std::optional<float> v)
+        {
+            int32_t ret = 0;
+            if (v)
+                std::memcpy(&ret, &*v, sizeof(ret));
+            return ret;
+        };
+        return {type.underlying(), transA, transB,
+                clampMin.has_value(), bits(clampMin),
+                clampMax.has_value(), bits(clampMax)};
+    }
+
 } // namespace infini
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "operators/reorder.h"
+
+namespace infini
+{
+    ReorderObj::ReorderObj(GraphObj *graph, Tensor input, Tensor output,
+                           int block)
+        : OperatorObj(OpType::Reorder, {input}, {output}), block(block)
+    {
+        IT_ASSERT(block >= 0);
+        IT_ASSERT(checkValid(graph));
+        if (outputs[0]->getBlock() != block)
+            outputs[0]->setBlock(block);
+    }
+
+    optional<vector<Shape>> ReorderObj::inferShape(const TensorVec &inputs)
+    {
+        return {{inputs[0]->getDims()}};
+    }
+
+    std::string ReorderObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        os << vecToString(inputs[0]->getDims()) << ",";
+        os << "block=" << inputs[0]->getBlock() << "->" << block << ",";
+        os << "input=" << inputs[0]->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+
+    vector<int> ReorderObj::getOpAttrVector() const
+    {
+        return {type.underlying(), block};
+    }
+
+} // namespace infini
@@ -11,7 +11,7 @@ namespace infini
         {
             for (size_t i = 0; i < rank; ++i)
             {
-                transposePermute[i] = i;
+                transposePermute.push_back(i);
             }
         }
         else
@@ -54,4 +54,21 @@ namespace infini
         os << "output=" << outputs[0]->getGuid() << ")";
         return os.str();
     }
+
+    vector<int> TransposeObj::getOpAttrVector() const
+    {
+        vector<int> ret{type.underlying()};
+        ret.insert(ret.end(), transposePermute.begin(), transposePermute.end());
+        return ret;
+    }
+
+    optional<vector<size_t>>
+    TransposeObj::getViewStrides(const vector<size_t> &inputStrides) const
+    {
+        IT_ASSERT(inputStrides.size() == transposePermute.size());
+        vector<size_t> strides;
+        for (int axis : transposePermute)
+            strides.emplace_back(inputStrides[axis]);
+        return strides;
+    }
 }; // namespace infini
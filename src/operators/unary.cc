@@ -25,6 +25,11 @@ namespace infini
         return os.str();
     }
 
+    vector<int> UnaryObj::getOpAttrVector() const
+    {
+        return {type.underlying()};
+    }
+
     ClipObj::ClipObj(GraphObj *graph, Tensor input, Tensor output,
                      std::optional<float> min, std::optional<float> max)
         : OperatorObj(OpType::Clip, {input}, {output}), minValue(min),
@@ -55,6 +60,20 @@ namespace infini
         return os.str();
     }
 
+    vector<int> ClipObj::getOpAttrVector() const
+    {
+        // Bounds are stored bitwise so that equal attributes compare equal.
+        auto bits = [](std::optional<float> v)
+        {
+            int32_t ret = 0;
+            if (v)
+                std::memcpy(&ret, &*v, sizeof(ret));
+            return ret;
+        };
+        return {type.underlying(), minValue.has_value(), bits(minValue),
+                maxValue.has_value(), bits(maxValue)};
+    }
+
     CastObj::CastObj(GraphObj *graph, Tensor input, Tensor output, CastType type)
         : OperatorObj(OpType::Cast, {input}, {output}), castType(type)
     {
@@ -91,6 +110,11 @@ namespace infini
         return os.str();
     }
 
+    vector<int> CastObj::getOpAttrVector() const
+    {
+        return {type.underlying(), enum_to_underlying(castType)};
+    }
+
     DataType CastObj::getOutputDataType() const
     {
         switch (castType)
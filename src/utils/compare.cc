@@ -0,0 +1,193 @@
+#include "utils/compare.h"
+#include "utils/float16.h"
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace infini {
+
+namespace {
+
+constexpr size_t BlockSize = 1 << 14;
+constexpr double Inf = std::numeric_limits<double>::infinity();
+
+struct ElementError {
+    bool mismatch;
+    double absError, relError;
+    uint64_t ulp;
+};
+
+template <typename T> uint64_t distance(T a, T b) {
+    // Unsigned subtraction is exact even when the signed one overflows.
+    return a > b ? uint64_t(a) - uint64_t(b) : uint64_t(b) - uint64_t(a);
+}
+
+// Maps the bits of an IEEE number of `Bits` to an integer in the order of
+// the values, so that adjacent values are one apart and both zeros are 0.
+template <typename Bits> int64_t orderedBits(Bits bits) {
+    constexpr Bits sign = Bits(1) << (sizeof(Bits) * 8 - 1);
+    int64_t magnitude = int64_t(bits & ~sign);
+    return bits & sign ? -magnitude : magnitude;
+}
+
+template <typename Bits> uint64_t ulpDistance(Bits a, Bits b) {
+    return distance(orderedBits(a), orderedBits(b));
+}
+
+inline ElementError compareFloat(double x, double y, uint64_t ulp,
+                                 double tolerance) {
+    bool nanX = std::isnan(x), nanY = std::isnan(y);
+    if (nanX || nanY) {
+        bool mismatch = nanX != nanY;
+        double error = mismatch ? Inf : 0;
+        return {mismatch, error, error,
+                mismatch ? std::numeric_limits<uint64_t>::max() : 0};
+    }
+    if (x == y)
+        return {false, 0, 0, 0};
+    double absError = std::fabs(x - y);
+    double larger = std::max(std::fabs(x), std::fabs(y));
+    double smaller = std::min(std::fabs(x), std::fabs(y));
+    double relError = std::isinf(larger) ? Inf : absError / larger;
+    bool mismatch = (smaller == 0 ? absError : relError) > tolerance;
+    return {mismatch, absError, relError, ulp};
+}
+
+template <typename T> ElementError compareInt(T x, T y) {
+    uint64_t diff = distance(x, y);
+    double larger = std::max(std::fabs(double(x)), std::fabs(double(y)));
+    return {diff != 0, double(diff), diff ? double(diff) / larger : 0, diff};
+}
+
+/**
+ * @brief Reduces the errors returned by `check` for every index, block by
+ * block. Blocks with mismatches are scanned again to collect indices, which
+ * keeps the reduction loop free of side effects.
+ */
+template <typename Check>
+CompareResult reduce(size_t size, size_t maxIndices, const Check &check) {
+    const size_t numBlocks = (size + BlockSize - 1) / BlockSize;
+    vector<CompareResult> blocks(numBlocks);
+#pragma omp parallel for schedule(static)
+    for (size_t block = 0; block < numBlocks; ++block) {
+        const size_t begin = block * BlockSize;
+        const size_t end = std::min(size, begin + BlockSize);
+        size_t mismatches = 0;
+        double maxAbs = 0, maxRel = 0;
+        uint64_t maxUlp = 0;
+#pragma omp simd reduction(+ : mismatches)                                     \
+    reduction(max : maxAbs, maxRel, maxUlp)
+        for (size_t i = begin; i < end; ++i) {
+            auto error = check(i);
+            mismatches += error.mismatch;
+            maxAbs = std::max(maxAbs, error.absError);
+            maxRel = std::max(maxRel, error.relError);
+            maxUlp = std::max(maxUlp, error.ulp);
+        }
+        auto &result = blocks[block];
+        result.mismatches = mismatches;
+        result.maxAbsError = maxAbs;
+        result.maxRelError = maxRel;
+        result.maxUlpError = maxUlp;
+        for (size_t i = begin; mismatches && i < end &&
+                               result.mismatchIndices.size() < maxIndices;
+             ++i)
+            if (check(i).mismatch)
+                result.mismatchIndices.push_back(i);
+    }
+
+    CompareResult ret;
+    ret.size = size;
+    for (const auto &block : blocks) {
+        ret.mismatches += block.mismatches;
+        ret.maxAbsError = std::max(ret.maxAbsError, block.maxAbsError);
+        ret.maxRelError = std::max(ret.maxRelError, block.maxRelError);
+        ret.maxUlpError = std::max(ret.maxUlpError, block.maxUlpError);
+        for (size_t i : block.mismatchIndices)
+            if (ret.mismatchIndices.size() < maxIndices)
+                ret.mismatchIndices.push_back(i);
+    }
+    return ret;
+}
+
+template <typename T>
+CompareResult compareInts(const void *a, const void *b, size_t size,
+                          size_t maxIndices) {
+    auto x = static_cast<const T *>(a), y = static_cast<const T *>(b);
+    return reduce(size, maxIndices,
+                  [=](size_t i) { return compareInt(x[i], y[i]); });
+}
+
+template <typename T, typename Bits>
+CompareResult compareFloats(const void *a, const void *b, size_t size,
+                            double tolerance, size_t maxIndices) {
+    auto x = static_cast<const T *>(a), y = static_cast<const T *>(b);
+    return reduce(size, maxIndices, [=](size_t i) {
+        Bits bx, by;
+        std::memcpy(&bx, &x[i], sizeof(Bits));
+        std::memcpy(&by, &y[i], sizeof(Bits));
+        return compareFloat(x[i], y[i], ulpDistance(bx, by), tolerance);
+    });
+}
+
+template <float (*toFloat)(uint16_t)>
+CompareResult compareHalves(const void *a, const void *b, size_t size,
+                            double tolerance, size_t maxIndices) {
+    auto x = static_cast<const uint16_t *>(a),
+         y = static_cast<const uint16_t *>(b);
+    return reduce(size, maxIndices, [=](size_t i) {
+        return compareFloat(toFloat(x[i]), toFloat(y[i]),
+                            ulpDistance(x[i], y[i]), tolerance);
+    });
+}
+
+} // namespace
+
+string CompareResult::toString() const {
+    std::ostringstream oss;
+    oss << mismatches << " of " << size << " elements differ, max abs error "
+        << maxAbsError << ", max rel error " << maxRelError << ", max ULP "
+        << maxUlpError;
+    if (!mismatchIndices.empty()) {
+        oss << ", first at";
+        for (size_t i : mismatchIndices)
+            oss << " " << i;
+    }
+    return oss.str();
+}
+
+CompareResult compareData(const void *a, const void *b, size_t size,
+                          DataType dtype, double relativeError,
+                          size_t maxIndices) {
+    if (dtype == DataType::Float32)
+        return compareFloats<float, uint32_t>(a, b, size, relativeError,
+                                              maxIndices);
+    if (dtype == DataType::Double)
+        return compareFloats<double, uint64_t>(a, b, size, relativeError,
+                                               maxIndices);
+    if (dtype == DataType::Float16)
+        return compareHalves<fp16ToFloat>(a, b, size, relativeError,
+                                          maxIndices);
+    if (dtype == DataType::BFloat16)
+        return compareHalves<bf16ToFloat>(a, b, size, relativeError,
+                                          maxIndices);
+    if (dtype == DataType::UInt8)
+        return compareInts<uint8_t>(a, b, size, maxIndices);
+    if (dtype == DataType::Int8 || dtype == DataType::Bool)
+        return compareInts<int8_t>(a, b, size, maxIndices);
+    if (dtype == DataType::UInt16)
+        return compareInts<uint16_t>(a, b, size, maxIndices);
+    if (dtype == DataType::Int16)
+        return compareInts<int16_t>(a, b, size, maxIndices);
+    if (dtype == DataType::Int32)
+        return compareInts<int32_t>(a, b, size, maxIndices);
+    if (dtype == DataType::Int64)
+        return compareInts<int64_t>(a, b, size, maxIndices);
+    if (dtype == DataType::UInt32)
+        return compareInts<uint32_t>(a, b, size, maxIndices);
+    if (dtype == DataType::UInt64)
+        return compareInts<uint64_t>(a, b, size, maxIndices);
+    IT_TODO_HALT_MSG("Cannot compare " + dtype.toString());
+}
+
+} // namespace infini
@@ -0,0 +1,177 @@
+#include "utils/data_generator.h"
+#include "utils/float16.h"
+#include <cmath>
+
+namespace infini {
+
+namespace {
+
+// Each chunk is filled by one thread from a buffer of random words.
+constexpr size_t ChunkSize = 4096;
+
+inline uint32_t mulhilo(uint32_t a, uint32_t b, uint32_t &hi) {
+    uint64_t product = uint64_t(a) * b;
+    hi = product >> 32;
+    return uint32_t(product);
+}
+
+// Philox block `pair` holds two random words for element 2 * pair and two
+// for element 2 * pair + 1.
+inline std::array<uint32_t, 4> randomBlock(size_t pair, uint64_t seed) {
+    return philox4x32({uint32_t(pair), uint32_t(uint64_t(pair) >> 32), 0, 0},
+                      {uint32_t(seed), uint32_t(seed >> 32)});
+}
+
+template <int N, typename V> typename DT<N>::t convert(V value) {
+    if constexpr (N == 10) // Float16
+        return floatToFp16(float(value));
+    else if constexpr (N == 16) // BFloat16
+        return floatToBf16(float(value));
+    else if constexpr (N == 9) // Bool
+        return value != 0;
+    else
+        return static_cast<typename DT<N>::t>(value);
+}
+
+template <int N> double toDouble(typename DT<N>::t value) {
+    if constexpr (N == 10) // Float16
+        return fp16ToFloat(value);
+    else if constexpr (N == 16) // BFloat16
+        return bf16ToFloat(value);
+    else
+        return double(value);
+}
+
+// The largest value of the data type below `upper`. Samples just below
+// `upper` may round up to it when converted, so they are clamped to this.
+template <int N> typename DT<N>::t largestBelow(double upper) {
+    // Step down by doubling distances until the converted value is below
+    // `upper`; the first distance of at least half a step of the data type
+    // lands on its largest value below `upper`.
+    double delta = std::max(std::fabs(upper), 1.) * 0x1p-60;
+    auto value = convert<N>(upper);
+    while (toDouble<N>(value) >= upper) {
+        value = convert<N>(upper - delta);
+        delta *= 2;
+    }
+    return value;
+}
+
+// Fills `ptr` with `sample` of the random bits of every element, converted
+// to the data type and kept below `upper`.
+template <int N, typename Sample>
+void fillRandom(void *ptr, size_t size, uint64_t seed, const Sample &sample,
+                double upper) {
+    using T = typename DT<N>::t;
+    auto data = static_cast<T *>(ptr);
+    const bool bounded = N != 9 && std::isfinite(upper); // not Bool
+    const T top = bounded ? largestBelow<N>(upper) : T{};
+    const size_t numChunks = (size + ChunkSize - 1) / ChunkSize;
+#pragma omp parallel for schedule(static)
+    for (size_t chunk = 0; chunk < numChunks; ++chunk) {
+        const size_t begin = chunk * ChunkSize;
+        const size_t end = std::min(size, begin + ChunkSize);
+        uint64_t bits[ChunkSize];
+        // Chunks start at even elements and ChunkSize is even, so every
+        // block fills a pair of slots of `bits`.
+#pragma omp simd
+        for (size_t i = begin; i < end; i += 2) {
+            auto words = randomBlock(i / 2, seed);
+            bits[i - begin] = uint64_t(words[1]) << 32 | words[0];
+            bits[i + 1 - begin] = uint64_t(words[3]) << 32 | words[2];
+        }
+#pragma omp simd
+        for (size_t i = begin; i < end; ++i) {
+            T value = convert<N>(sample(bits[i - begin]));
+            if (bounded && toDouble<N>(value) >= upper)
+                value = top;
+            data[i] = value;
+        }
+    }
+}
+
+template <typename Sample>
+void dispatch(void *data, size_t size, DataType dataType, uint64_t seed,
+              const Sample &sample, double upper = INFINITY) {
+#define CASE(N)                                                                \
+    case N:                                                                    \
+        return fillRandom<N>(data, size, seed, sample, upper);
+
+    switch (dataType.getIndex()) {
+        CASE(1)  // Float32
+        CASE(2)  // UInt8
+        CASE(3)  // Int8
+        CASE(4)  // UInt16
+        CASE(5)  // Int16
+        CASE(6)  // Int32
+        CASE(7)  // Int64
+        CASE(9)  // Bool
+        CASE(10) // Float16
+        CASE(11) // Double
+        CASE(12) // UInt32
+        CASE(13) // UInt64
+        CASE(16) // BFloat16
+    default:
+        IT_TODO_HALT_MSG("Cannot generate " + dataType.toString());
+    }
+
+#undef CASE
+}
+
+} // namespace
+
+std::array<uint32_t, 4> philox4x32(std::array<uint32_t, 4> counter,
+                                   std::array<uint32_t, 2> key) {
+    for (int round = 0; round < 10; ++round) {
+        if (round > 0) {
+            key[0] += 0x9E3779B9;
+            key[1] += 0xBB67AE85;
+        }
+        uint32_t hi0, hi1;
+        uint32_t lo0 = mulhilo(0xD2511F53, counter[0], hi0);
+        uint32_t lo1 = mulhilo(0xCD9E8D57, counter[2], hi1);
+        counter = {hi1 ^ counter[1] ^ key[0], lo1, hi0 ^ counter[3] ^ key[1],
+                   lo0};
+    }
+    return counter;
+}
+
+void RandomGenerator::operator()(void *data, size_t size,
+                                 DataType dataType) const {
+    switch (distribution) {
+    case Distribution::Uniform: {
+        const double low = a, scale = b - a;
+        // Rounding to the data type could reach `b`, so samples are kept
+        // below it.
+        dispatch(
+            data, size, dataType, seed,
+            [=](uint64_t bits) {
+                return low + scale * (double(bits >> 11) * 0x1p-53);
+            },
+            b);
+        break;
+    }
+    case Distribution::Normal: {
+        const double mean = a, stddev = b;
+        // Box-Muller with the high word in (0, 1] and the low one in [0, 1).
+        dispatch(data, size, dataType, seed, [=](uint64_t bits) {
+            double u1 = (double(bits >> 32) + 1) * 0x1p-32;
+            double u2 = double(uint32_t(bits)) * 0x1p-32;
+            return mean + stddev * std::sqrt(-2 * std::log(u1)) *
+                              std::cos(2 * M_PI * u2);
+        });
+        break;
+    }
+    case Distribution::IntRange: {
+        // The span wraps to 0 for the whole range of int64_t.
+        const uint64_t span = uint64_t(high) - uint64_t(low) + 1;
+        const int64_t base = low;
+        dispatch(data, size, dataType, seed, [=](uint64_t bits) {
+            return int64_t(uint64_t(base) + (span ? bits % span : bits));
+        });
+        break;
+    }
+    }
+}
+
+} // namespace infini
@@ -0,0 +1,26 @@
+#include "utils/mapped_file.h"
+#include "core/common.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace infini {
+
+std::shared_ptr<void> mapFile(const std::string &path, size_t &size) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    IT_ASSERT(fd >= 0, "Cannot open " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        IT_ASSERT(false, "Cannot read " + path);
+    }
+    size = st.st_size;
+    void *addr =
+        ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    IT_ASSERT(addr != MAP_FAILED, "Cannot map " + path);
+    return std::shared_ptr<void>(addr, [size](void *p) { ::munmap(p, size); });
+}
+
+} // namespace infini
@@ -0,0 +1,121 @@
+#include "utils/perf_counter.h"
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace infini {
+
+PerfCounterValues
+PerfCounterValues::operator-(const PerfCounterValues &rhs) const {
+    PerfCounterValues ans;
+    ans.cycles = cycles - rhs.cycles;
+    ans.instructions = instructions - rhs.instructions;
+    ans.llcReferences = llcReferences - rhs.llcReferences;
+    ans.llcMisses = llcMisses - rhs.llcMisses;
+    ans.branches = branches - rhs.branches;
+    ans.branchMisses = branchMisses - rhs.branchMisses;
+    return ans;
+}
+
+PerfCounterValues &PerfCounterValues::operator+=(const PerfCounterValues &rhs) {
+    cycles += rhs.cycles;
+    instructions += rhs.instructions;
+    llcReferences += rhs.llcReferences;
+    llcMisses += rhs.llcMisses;
+    branches += rhs.branches;
+    branchMisses += rhs.branchMisses;
+    return *this;
+}
+
+PerfCounters::PerfCounters() {
+    for (auto &fd : fds)
+        fd = -1;
+}
+
+PerfCounters::~PerfCounters() { close(); }
+
+#ifdef __linux__
+
+// Order matches the fields of PerfCounterValues.
+static const uint64_t eventConfigs[PerfCounters::NumEvents] = {
+    PERF_COUNT_HW_CPU_CYCLES,       PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES};
+
+bool PerfCounters::open() {
+    if (opened)
+        return true;
+    // Fall back to the calling thread alone where the kernel rejects
+    // inherited events.
+    return openGroup(true) || openGroup(false);
+}
+
+bool PerfCounters::openGroup(bool inherit) {
+    for (int i = 0; i < NumEvents; ++i) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = eventConfigs[i];
+        attr.disabled = i == 0; // the group starts with its leader
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.inherit = inherit;
+        attr.read_format = PERF_FORMAT_GROUP;
+        fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1,
+                         i == 0 ? -1 : fds[0], 0);
+        if (fds[i] < 0) {
+            close();
+            return false;
+        }
+    }
+    ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    inherited = inherit;
+    return opened = true;
+}
+
+void PerfCounters::close() {
+    for (auto &fd : fds) {
+        if (fd >= 0)
+            ::close(fd);
+        fd = -1;
+    }
+    opened = inherited = false;
+}
+
+PerfCounterValues PerfCounters::read() const {
+    PerfCounterValues ans;
+    if (!opened)
+        return ans;
+    // PERF_FORMAT_GROUP layout: { nr, values[nr] }
+    uint64_t buf[1 + NumEvents];
+    if (::read(fds[0], buf, sizeof(buf)) != sizeof(buf) || buf[0] != NumEvents)
+        return ans;
+    ans.cycles = buf[1];
+    ans.instructions = buf[2];
+    ans.llcReferences = buf[3];
+    ans.llcMisses = buf[4];
+    ans.branches = buf[5];
+    ans.branchMisses = buf[6];
+    return ans;
+}
+
+#else
+
+bool PerfCounters::open() { return false; }
+
+bool PerfCounters::openGroup(bool) { return false; }
+
+void PerfCounters::close() { opened = inherited = false; }
+
+PerfCounterValues PerfCounters::read() const { return {}; }
+
+#endif
+
+} // namespace infini
@@ -71,4 +71,23 @@ namespace infini
         EXPECT_EQ(ptr1, ptr2);
     }
 
+    TEST(Allocator, testGrowAndReset)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Allocator allocator = Allocator(runtime);
+        // The arena is not limited to a fixed size.
+        size_t offsetA = allocator.alloc(4 << 20);
+        size_t offsetB = allocator.alloc(4 << 20);
+        EXPECT_EQ(offsetA, 0u);
+        EXPECT_EQ(offsetB, 4u << 20);
+        // Freeing the top block shrinks the arena, so a larger block
+        // reuses its space.
+        allocator.free(offsetB, 4 << 20);
+        EXPECT_EQ(allocator.alloc(8 << 20), offsetB);
+        EXPECT_NE(allocator.getPtr(), nullptr);
+
+        allocator.reset();
+        EXPECT_EQ(allocator.alloc(16), 0u);
+    }
+
 } // namespace infini
@@ -0,0 +1,53 @@
+#include "core/autotuner.h"
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/transpose.h"
+
+#include "test.h"
+#include <filesystem>
+
+namespace infini
+{
+    TEST(Autotuner, CachesAndPersistsChoice)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto input = g->addTensor({64, 48}, DataType::Float32);
+        auto op = g->addOp<TransposeObj>(input, nullptr, Shape{1, 0});
+        g->dataMalloc();
+        input->setData(IncrementalGenerator());
+
+        const string path = (std::filesystem::temp_directory_path() /
+                             "infini_test_autotuner_cache.txt")
+                                .string();
+        std::remove(path.c_str());
+        auto &autotuner = Autotuner::getInstance();
+        autotuner.clear();
+        autotuner.setCacheFile(path);
+        autotuner.enable();
+        runtime->run(g);
+        autotuner.disable();
+
+        auto attrs = KernelAttrs{Device::CPU, OpType::Transpose};
+        auto key = Autotuner::workloadKey(attrs, op);
+        ASSERT_EQ(autotuner.getCache().count(key), 1u);
+        auto choice = autotuner.getCache().at(key);
+        EXPECT_NE(KernelRegistry::getInstance().getKernelItem(attrs, choice),
+                  nullptr);
+
+        vector<float> ans(input->size());
+        for (int i = 0; i < 64; ++i)
+            for (int j = 0; j < 48; ++j)
+                ans[j * 64 + i] = i * 48 + j;
+        EXPECT_TRUE(op->getOutput()->equalData(ans));
+
+        // A new process would start from the persisted file.
+        autotuner.clear();
+        autotuner.setCacheFile(path);
+        EXPECT_EQ(autotuner.getCache().at(key), choice);
+        autotuner.clear();
+        autotuner.setCacheFile("");
+        std::remove(path.c_str());
+    }
+
+} // namespace infini
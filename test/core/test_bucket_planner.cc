@@ -0,0 +1,93 @@
+#include "core/bucket_planner.h"
+#include "core/runtime.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(BucketPlanner, PlansEveryBucket)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({1, 1, 4}, DataType::Float32);
+        auto y = g->addTensor({1, 1, 4}, DataType::Float32);
+        auto add = g->addOp<AddObj>(x, y, nullptr);
+        auto relu = g->addOp<ReluObj>(add->getOutput(), nullptr);
+        auto concat = g->addOp<ConcatObj>(
+            TensorVec{relu->getOutput(), x}, nullptr, 1);
+
+        BucketPlanner planner(g);
+        planner.addSymbol("batch", x, 0);
+        planner.addSymbol("batch", y, 0);
+        planner.addSymbol("seq", x, 1);
+        planner.addSymbol("seq", y, 1);
+        planner.setBuckets("batch", {1, 2});
+        planner.setBuckets("seq", BucketPlanner::powersOfTwo(2, 6));
+        EXPECT_EQ(BucketPlanner::powersOfTwo(2, 6), (vector<int>{2, 4, 6}));
+        planner.plan();
+        EXPECT_EQ(planner.getNumBuckets(), 6u);
+        // The largest bucket is bound after planning.
+        EXPECT_EQ(planner.getBucket(), (vector<int>{2, 6}));
+        EXPECT_EQ(planner.getSymbolicShape(concat->getOutput()),
+                  (vector<string>{"batch", "2*seq", "4"}));
+
+        // Sequences of length 3 run in the bucket of length 4.
+        auto plan = planner.select({1, 3});
+        EXPECT_EQ(planner.getBucket(), (vector<int>{1, 4}));
+        EXPECT_EQ(x->getDims(), (Shape{1, 4, 4}));
+        EXPECT_EQ(concat->getOutput()->getDims(), (Shape{1, 8, 4}));
+        vector<float> data(12);
+        for (size_t i = 0; i < data.size(); ++i)
+            data[i] = i;
+        BucketPlanner::copyPadded(x, data.data(), {1, 3, 4});
+        y->setData(OneGenerator());
+        runtime->run(plan);
+        vector<float> ans;
+        for (int i = 0; i < 16; ++i)
+            ans.push_back(i < 12 ? i + 1 : 1);
+        for (int i = 0; i < 16; ++i)
+            ans.push_back(i < 12 ? i : 0);
+        EXPECT_TRUE(concat->getOutput()->equalData(ans));
+
+        // Buckets share the arena, so switching back does not allocate.
+        auto ptr = x->getRawDataPtr<void *>();
+        EXPECT_EQ(planner.select({1, 4}), plan);
+        planner.select({2, 5});
+        EXPECT_EQ(x->getDims(), (Shape{2, 6, 4}));
+        EXPECT_EQ(planner.select({1, 1}), planner.select({1, 2}));
+        planner.select({1, 4});
+        EXPECT_EQ(x->getRawDataPtr<void *>(), ptr);
+    }
+
+    TEST(BucketPlanner, MatmulPerBucket)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({1, 3}, DataType::Float32);
+        auto b = g->addTensor({3, 2}, DataType::Float32);
+        b->setConstant(IncrementalGenerator());
+        auto matmul = g->addOp<MatmulObj>(a, b, nullptr);
+
+        BucketPlanner planner(g);
+        planner.addSymbol("m", a, 0);
+        planner.setBuckets("m", {1, 4});
+        planner.plan();
+
+        // Each plan lowers the M of its own bucket, not of the last one
+        // inferred.
+        auto plan = planner.select({1});
+        ASSERT_EQ(plan->size(), 1u);
+        EXPECT_EQ(plan->getRecords()[0].attrs.matmul.m, 1);
+        EXPECT_EQ(planner.select({4})->getRecords()[0].attrs.matmul.m, 4);
+
+        plan = planner.select({1});
+        a->setData(IncrementalGenerator());
+        runtime->run(plan);
+        EXPECT_TRUE(matmul->getOutput()->equalData(vector<float>{10, 13}));
+    }
+
+} // namespace infini
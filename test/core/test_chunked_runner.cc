@@ -0,0 +1,106 @@
+#include "core/chunked_runner.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(ChunkedRunner, MatchesWholeRun)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        const int rows = 10;
+        // Two copies of Relu(x * w + b) and y^T + c over rows of x and y:
+        // one run whole, one run in chunks.
+        Graph graphs[2];
+        for (auto &g : graphs)
+        {
+            g = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({rows, 4}, DataType::Float32);
+            auto y = g->addTensor({rows, 2, 3}, DataType::Float32);
+            auto w = g->addTensor({4, 6}, DataType::Float32);
+            auto b = g->addTensor({6}, DataType::Float32);
+            auto c = g->addTensor({3, 2}, DataType::Float32);
+            w->setConstant(IncrementalGenerator());
+            b->setConstant(OneGenerator());
+            c->setConstant(IncrementalGenerator());
+            auto mm = g->addOp<MatmulObj>(x, w, nullptr, false, false, b);
+            g->addOp<ReluObj>(mm->getOutput(), nullptr);
+            auto t = g->addOp<TransposeObj>(y, nullptr, Shape{0, 2, 1});
+            g->addOp<AddObj>(t->getOutput(), c, nullptr);
+        }
+        Graph whole = graphs[0];
+        whole->dataMalloc();
+        auto wholeInputs = whole->getInputs();
+        vector<vector<float>> inputData;
+        for (const auto &input : wholeInputs)
+            if (!input->isConstant())
+            {
+                input->setData(IncrementalGenerator());
+                inputData.emplace_back(input->size());
+                std::memcpy(inputData.back().data(),
+                            input->getRawDataPtr<void *>(),
+                            input->getBytes());
+            }
+        runtime->run(whole);
+
+        // Chunks of 4, 4 and 2 rows.
+        ChunkedRunner runner(graphs[1], 4);
+        ASSERT_EQ(runner.getInputs().size(), inputData.size());
+        vector<const void *> sources;
+        for (const auto &data : inputData)
+            sources.emplace_back(data.data());
+        auto wholeOutputs = whole->getOutputs();
+        ASSERT_EQ(runner.getOutputs().size(), wholeOutputs.size());
+        vector<vector<float>> results;
+        vector<void *> sinks;
+        for (const auto &output : wholeOutputs)
+        {
+            results.emplace_back(output->size());
+            sinks.emplace_back(results.back().data());
+        }
+        size_t chunks = 0;
+        auto sink = runner.toBuffers(sinks);
+        runner.run(rows, runner.fromBuffers(sources),
+                   [&](const Tensor &output, size_t row, size_t n,
+                       const void *data)
+                   {
+                       chunks += output == runner.getOutputs()[0];
+                       sink(output, row, n, data);
+                   });
+
+        EXPECT_EQ(chunks, 3u);
+        for (size_t i = 0; i < results.size(); ++i)
+            EXPECT_TRUE(wholeOutputs[i]->equalData(results[i]));
+        EXPECT_LT(runner.getArenaSize(), whole->getMemoryPlan().size);
+    }
+
+    TEST(ChunkedRunner, RejectsRowMixing)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({8, 4}, DataType::Float32);
+        auto w = g->addTensor({8, 4}, DataType::Float32);
+        w->setConstant(IncrementalGenerator());
+        // Every output element reads all rows of x.
+        g->addOp<MatmulObj>(x, w, nullptr, true);
+        EXPECT_FALSE(ChunkedRunner::isChunkable(g));
+
+        // Each row of x * v only reads the same row of x.
+        Graph f = make_ref<GraphObj>(runtime);
+        auto z = f->addTensor({8, 4}, DataType::Float32);
+        auto v = f->addTensor({4, 6}, DataType::Float32);
+        v->setConstant(IncrementalGenerator());
+        f->addOp<MatmulObj>(z, v, nullptr);
+        EXPECT_TRUE(ChunkedRunner::isChunkable(f));
+
+        Graph h = make_ref<GraphObj>(runtime);
+        auto y = h->addTensor({8, 4}, DataType::Float32);
+        h->addOp<TransposeObj>(y, nullptr, Shape{1, 0});
+        EXPECT_FALSE(ChunkedRunner::isChunkable(h));
+    }
+
+} // namespace infini
@@ -0,0 +1,106 @@
+#include "core/runtime.h"
+#include "core/tensor.h"
+#include "utils/compare.h"
+#include "utils/float16.h"
+
+#include "test.h"
+#include <cmath>
+#include <cstring>
+
+namespace infini
+{
+    TEST(Compare, Float32)
+    {
+        // Spans several blocks, so the per-block results are merged.
+        const size_t size = 100000;
+        vector<float> a(size), b(size);
+        for (size_t i = 0; i < size; ++i)
+            a[i] = b[i] = std::sin(float(i));
+        auto same = compareData(a.data(), b.data(), size, DataType::Float32);
+        EXPECT_TRUE(same.equal());
+        EXPECT_EQ(same.maxUlpError, 0u);
+
+        b[70000] = std::nextafter(a[70000], 2.f);
+        b[123] = a[123] + 0.5f;
+        b[99999] = NAN;
+        auto diff = compareData(a.data(), b.data(), size, DataType::Float32,
+                                1e-6, 2);
+        EXPECT_EQ(diff.mismatches, 2u);
+        EXPECT_EQ(diff.mismatchIndices, (vector<size_t>{123, 99999}));
+        EXPECT_TRUE(std::isinf(diff.maxAbsError));
+
+        b[99999] = a[99999];
+        diff = compareData(a.data(), b.data(), size, DataType::Float32);
+        EXPECT_EQ(diff.mismatches, 1u);
+        EXPECT_FLOAT_EQ(diff.maxAbsError, 0.5f);
+        EXPECT_GT(diff.maxUlpError, 1u);
+
+        b[123] = a[123];
+        diff = compareData(a.data(), b.data(), size, DataType::Float32, 0);
+        EXPECT_EQ(diff.mismatchIndices, (vector<size_t>{70000}));
+        EXPECT_EQ(diff.maxUlpError, 1u);
+    }
+
+    TEST(Compare, ZerosAndNaN)
+    {
+        vector<float> a{0.f, NAN, 1e-7f, 1.f}, b{-0.f, NAN, 0.f, 1.f};
+        auto result = compareData(a.data(), b.data(), 4, DataType::Float32);
+        EXPECT_TRUE(result.equal());
+        // Positive floats are ordered like their bit patterns, so the ULP
+        // distance from 0 to 1e-7f is the bit pattern of 1e-7f.
+        uint32_t bits;
+        std::memcpy(&bits, &a[2], sizeof(bits));
+        EXPECT_EQ(result.maxUlpError, bits);
+        b[3] = -1.f;
+        result = compareData(a.data(), b.data(), 4, DataType::Float32);
+        EXPECT_EQ(result.mismatchIndices, (vector<size_t>{3}));
+        EXPECT_DOUBLE_EQ(result.maxRelError, 2.);
+    }
+
+    TEST(Compare, HalfPrecision)
+    {
+        for (auto [dtype, convert] :
+             {std::pair{DataType::Float16, floatToFp16},
+              std::pair{DataType::BFloat16, floatToBf16}})
+        {
+            vector<uint16_t> a{convert(1.f), convert(-2.f), convert(0.f)};
+            vector<uint16_t> b = a;
+            b[1] = a[1] + 1; // one ULP further from zero
+            b[2] = convert(-0.f);
+            auto result = compareData(a.data(), b.data(), 3, dtype, 1e-2);
+            EXPECT_TRUE(result.equal());
+            EXPECT_EQ(result.maxUlpError, 1u);
+            result = compareData(a.data(), b.data(), 3, dtype, 1e-6);
+            EXPECT_EQ(result.mismatchIndices, (vector<size_t>{1}));
+        }
+    }
+
+    TEST(Compare, Integers)
+    {
+        vector<int64_t> a{5, -3, INT64_MIN}, b{5, 4, INT64_MAX};
+        auto result = compareData(a.data(), b.data(), 3, DataType::Int64);
+        EXPECT_EQ(result.mismatches, 2u);
+        EXPECT_EQ(result.maxUlpError, UINT64_MAX);
+
+        vector<int8_t> x{1, 0, 1}, y{1, 0, 1};
+        EXPECT_TRUE(compareData(x.data(), y.data(), 3, DataType::Bool).equal());
+    }
+
+    TEST(Compare, Tensors)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto a = make_ref<TensorObj>(Shape{2, 3}, DataType::Float32, runtime);
+        auto b = make_ref<TensorObj>(Shape{2, 3}, DataType::Float32, runtime);
+        a->setDataBlob(make_ref<BlobObj>(runtime, a->getBytes()));
+        b->setDataBlob(make_ref<BlobObj>(runtime, b->getBytes()));
+        a->setData(IncrementalGenerator());
+        b->setData(IncrementalGenerator());
+        EXPECT_TRUE(a->equalData(b));
+        b->getRawDataPtr<float *>()[4] += 1e-3f;
+        EXPECT_EQ(a->compare(b).mismatchIndices, (vector<size_t>{4}));
+        EXPECT_FALSE(a->equalData(b));
+        EXPECT_TRUE(a->equalData(b, 1e-3));
+        EXPECT_TRUE(b->equalData(vector<float>{0, 1, 2, 3, 4.001f, 5}));
+    }
+
+} // namespace infini
@@ -0,0 +1,108 @@
+#include "core/tensor.h"
+#include "utils/data_generator.h"
+#include "utils/float16.h"
+
+#include "test.h"
+#include <cmath>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace infini
+{
+    TEST(DataGenerator, PhiloxKnownAnswers)
+    {
+        // Test vectors of the Random123 reference implementation.
+        EXPECT_EQ(philox4x32({0, 0, 0, 0}, {0, 0}),
+                  (std::array<uint32_t, 4>{0x6627e8d5, 0xe169c58d,
+                                           0xbc57ac4c, 0x9b00dbd8}));
+        EXPECT_EQ(philox4x32({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+                             {0xa4093822, 0x299f31d0}),
+                  (std::array<uint32_t, 4>{0xd16cfe09, 0x94fdcceb,
+                                           0x5001e420, 0x24126ea1}));
+    }
+
+    TEST(DataGenerator, Reproducible)
+    {
+        const size_t size = 50000;
+        vector<float> a(size), b(size - 7);
+        UniformGenerator(-1, 1, 42)(a.data(), size, DataType::Float32);
+#ifdef _OPENMP
+        int threads = omp_get_max_threads();
+        omp_set_num_threads(3);
+#endif
+        UniformGenerator(-1, 1, 42)(b.data(), b.size(), DataType::Float32);
+#ifdef _OPENMP
+        omp_set_num_threads(threads);
+#endif
+        // The shorter fill is a prefix of the longer one.
+        EXPECT_TRUE(std::equal(b.begin(), b.end(), a.begin()));
+        UniformGenerator(-1, 1, 43)(b.data(), b.size(), DataType::Float32);
+        EXPECT_FALSE(std::equal(b.begin(), b.end(), a.begin()));
+    }
+
+    TEST(DataGenerator, Distributions)
+    {
+        const size_t size = 100000;
+        vector<double> u(size), n(size);
+        UniformGenerator(2, 5)(u.data(), size, DataType::Double);
+        NormalGenerator(1, 3)(n.data(), size, DataType::Double);
+        double uSum = 0, nSum = 0, nSquares = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            EXPECT_TRUE(u[i] >= 2 && u[i] < 5);
+            uSum += u[i];
+            nSum += n[i];
+            nSquares += n[i] * n[i];
+        }
+        double mean = nSum / size;
+        EXPECT_NEAR(uSum / size, 3.5, 0.02);
+        EXPECT_NEAR(mean, 1, 0.05);
+        EXPECT_NEAR(std::sqrt(nSquares / size - mean * mean), 3, 0.05);
+
+        vector<int8_t> ints(size);
+        IntRangeGenerator(-3, 4)(ints.data(), size, DataType::Int8);
+        EXPECT_EQ(*std::min_element(ints.begin(), ints.end()), -3);
+        EXPECT_EQ(*std::max_element(ints.begin(), ints.end()), 4);
+
+        vector<int64_t> wide(16);
+        IntRangeGenerator(INT64_MIN, INT64_MAX)(wide.data(), wide.size(),
+                                                DataType::Int64);
+        EXPECT_NE(wide[0], wide[1]);
+    }
+
+    TEST(DataGenerator, HalfPrecision)
+    {
+        vector<uint16_t> fp16(1000), bf16(1000);
+        UniformGenerator(-4, 4)(fp16.data(), fp16.size(), DataType::Float16);
+        UniformGenerator(-4, 4)(bf16.data(), bf16.size(), DataType::BFloat16);
+        for (size_t i = 0; i < fp16.size(); ++i)
+        {
+            // The same samples, rounded to each format.
+            EXPECT_NEAR(fp16ToFloat(fp16[i]), bf16ToFloat(bf16[i]), 0.04);
+            EXPECT_LE(std::fabs(fp16ToFloat(fp16[i])), 4.f);
+        }
+
+        // About one sample in 256 would round up to the bound, which is
+        // excluded from the range.
+        vector<uint16_t> narrow(100000);
+        UniformGenerator(1, 2)(narrow.data(), narrow.size(),
+                               DataType::BFloat16);
+        float largest = 0;
+        for (auto value : narrow)
+            largest = std::max(largest, bf16ToFloat(value));
+        EXPECT_EQ(largest, 2.f - 0x1p-7f);
+    }
+
+    TEST(DataGenerator, SetData)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto t = make_ref<TensorObj>(Shape{4, 5}, DataType::UInt32, runtime);
+        t->setDataBlob(make_ref<BlobObj>(runtime, t->getBytes()));
+        t->setData(IntRangeGenerator(10, 20, 7));
+        auto data = t->getRawDataPtr<uint32_t *>();
+        for (size_t i = 0; i < t->size(); ++i)
+            EXPECT_TRUE(data[i] >= 10 && data[i] <= 20);
+    }
+
+} // namespace infini
@@ -0,0 +1,114 @@
+#include "core/graph.h"
+#include "core/plan.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    // Relu(x^T + c) with c = [0, 1, ..., 11].
+    static vector<float> reference(const vector<float> &x)
+    {
+        vector<float> ans(12);
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 4; ++j)
+                ans[i * 4 + j] = std::max(x[j * 3 + i] + i * 4 + j, 0.f);
+        return ans;
+    }
+
+    TEST(ExternalBinding, BindInputsAndOutputs)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        // out = Relu(x^T + c)
+        auto x = g->addTensor({4, 3}, DataType::Float32);
+        auto c = g->addTensor({3, 4}, DataType::Float32);
+        c->setConstant(IncrementalGenerator());
+        auto t = g->addOp<TransposeObj>(x, nullptr, Shape{1, 0});
+        auto add = g->addOp<AddObj>(t->getOutput(), c, nullptr);
+        auto out = g->addOp<ReluObj>(add->getOutput(), nullptr)->getOutput();
+        g->dataMalloc();
+        const auto arena = g->getMemoryPlan().size;
+
+        vector<float> in1(12), in2(12), out1(12), out2(12);
+        for (int i = 0; i < 12; ++i)
+        {
+            in1[i] = i - 6;
+            in2[i] = 10 - i * 2;
+        }
+        g->bindExternal(x, in1.data());
+        g->bindExternal(out, out1.data());
+        EXPECT_TRUE(x->isExternal());
+        EXPECT_TRUE(out->isExternal());
+        EXPECT_LT(g->getMemoryPlan().size, arena);
+        // The input is no longer viewed by the Transpose.
+        EXPECT_FALSE(g->getOperators()[0]->getOutput()->isView());
+
+        g->setCaptureMode(true);
+        runtime->run(g);
+        EXPECT_EQ(out1, reference(in1));
+
+        // Binding other buffers keeps the captured plan.
+        auto plan = g->getCapturedPlan();
+        g->bindExternal(x, in2.data());
+        g->bindExternal(out, out2.data());
+        runtime->run(g);
+        EXPECT_EQ(g->getCapturedPlan(), plan);
+        EXPECT_EQ(out2, reference(in2));
+        EXPECT_EQ(out1, reference(in1));
+
+        g->unbindExternal(out);
+        EXPECT_FALSE(out->isExternal());
+        runtime->run(g);
+        EXPECT_TRUE(out->equalData(reference(in2)));
+    }
+
+    TEST(ExternalBinding, CompiledPlanRebindsExplicitly)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        // out = Relu(x^T + c)
+        auto x = g->addTensor({4, 3}, DataType::Float32);
+        auto c = g->addTensor({3, 4}, DataType::Float32);
+        c->setConstant(IncrementalGenerator());
+        auto t = g->addOp<TransposeObj>(x, nullptr, Shape{1, 0});
+        auto add = g->addOp<AddObj>(t->getOutput(), c, nullptr);
+        auto out = g->addOp<ReluObj>(add->getOutput(), nullptr)->getOutput();
+        vector<float> in(12), out1(12), out2(12);
+        for (int i = 0; i < 12; ++i)
+            in[i] = i - 6;
+        g->bindExternal(x, in.data());
+        g->bindExternal(out, out1.data());
+        g->dataMalloc();
+        auto plan = g->compile();
+
+        // Running does not touch the plan, so it keeps the old buffer until
+        // its owner updates it.
+        g->bindExternal(out, out2.data());
+        runtime->run(plan);
+        EXPECT_EQ(out1, reference(in));
+        EXPECT_EQ(out2, vector<float>(12));
+        plan->updateExternals();
+        runtime->run(plan);
+        EXPECT_EQ(out2, reference(in));
+    }
+
+    TEST(ExternalBinding, RejectsIntermediates)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({4, 3}, DataType::Float32);
+        auto mid = g->addOp<TransposeObj>(x, nullptr, Shape{1, 0})->getOutput();
+        g->addOp<ReluObj>(mid, nullptr);
+        vector<float> buffer(12);
+        EXPECT_THROW(g->bindExternal(mid, buffer.data()), Exception);
+        EXPECT_THROW(g->bindExternal(x, nullptr), Exception);
+        EXPECT_THROW(
+            g->bindExternal(x, reinterpret_cast<char *>(buffer.data()) + 1),
+            Exception);
+    }
+
+} // namespace infini
@@ -1,8 +1,10 @@
 #include "core/graph.h"
 #include "core/kernel.h"
 #include "core/runtime.h"
+#include "operators/element_wise.h"
 #include "operators/matmul.h"
 #include "operators/transpose.h"
+#include "operators/unary.h"
 
 #include "test.h"
 
@@ -37,4 +39,284 @@ namespace infini
         EXPECT_EQ(op->getTransA(), false);
         EXPECT_EQ(op->getTransB(), true);
     }
-}
\ No newline at end of file
+    // out = Add(Transpose(Relu(Transpose(x, p)), p^-1), y) and
+    // mm = MatMul(Transpose(Transpose(a, q), r), b) where q o r swaps the last
+    // two axes of a.
+    static Tensor buildTransposeGraph(const Graph &g, const Tensor &x,
+                                      const Tensor &y, const Tensor &a,
+                                      const Tensor &b, Tensor &mm)
+    {
+        auto t0 = g->addOp<TransposeObj>(x, nullptr, Shape{1, 2, 0});
+        auto relu = g->addOp<ReluObj>(t0->getOutput(), nullptr);
+        auto t1 =
+            g->addOp<TransposeObj>(relu->getOutput(), nullptr, Shape{2, 0, 1});
+        auto add = g->addOp<AddObj>(t1->getOutput(), y, nullptr);
+        auto t2 = g->addOp<TransposeObj>(a, nullptr, Shape{1, 0, 2});
+        auto t3 = g->addOp<TransposeObj>(t2->getOutput(), nullptr,
+                                         Shape{1, 2, 0});
+        mm = g->addOp<MatmulObj>(t3->getOutput(), b, nullptr)->getOutput();
+        return add->getOutput();
+    }
+
+    TEST(Graph, CanonicalizeTranspose)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph graphs[2];
+        Tensor outs[2], mms[2];
+        for (int optimized = 0; optimized < 2; ++optimized)
+        {
+            Graph g = graphs[optimized] = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({2, 3, 4}, DataType::Float32);
+            auto y = g->addTensor({2, 3, 4}, DataType::Float32);
+            auto a = g->addTensor({2, 5, 3}, DataType::Float32);
+            auto b = g->addTensor({5, 4}, DataType::Float32);
+            outs[optimized] = buildTransposeGraph(g, x, y, a, b, mms[optimized]);
+            if (optimized)
+            {
+                EXPECT_TRUE(g->canonicalizeTranspose());
+                EXPECT_TRUE(g->checkValid());
+                for (const auto &op : g->getOperators())
+                    EXPECT_NE(op->getOpType(), OpType::Transpose);
+                EXPECT_EQ(g->getOperators().size(), 3u);
+                auto matmul = as<MatmulObj>(mms[optimized]->getSource());
+                EXPECT_EQ(matmul->getInputs(0), a);
+                EXPECT_TRUE(matmul->getTransA());
+                EXPECT_FALSE(g->canonicalizeTranspose());
+            }
+            g->dataMalloc();
+            x->setData(IncrementalGenerator());
+            y->setData(IncrementalGenerator());
+            a->setData(IncrementalGenerator());
+            b->setData(IncrementalGenerator());
+            runtime->run(g);
+        }
+        EXPECT_TRUE(outs[1]->equalData(outs[0]));
+        EXPECT_TRUE(mms[1]->equalData(mms[0]));
+    }
+
+    TEST(Graph, FoldConstants)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph graphs[2];
+        Tensor outs[2];
+        for (int folded = 0; folded < 2; ++folded)
+        {
+            // MatMul(x, Cast(Cast(Transpose(w)))) with a constant weight w.
+            Graph g = graphs[folded] = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({2, 4}, DataType::Float32);
+            auto w = g->addTensor({3, 4}, DataType::Float32);
+            w->setConstant(IncrementalGenerator());
+            auto t = g->addOp<TransposeObj>(w, nullptr, Shape{1, 0});
+            auto half = g->addOp<CastObj>(t->getOutput(), nullptr,
+                                          CastType::Float2Float16);
+            auto back = g->addOp<CastObj>(half->getOutput(), nullptr,
+                                          CastType::Float162Float);
+            auto mm = g->addOp<MatmulObj>(x, back->getOutput(), nullptr);
+            outs[folded] = mm->getOutput();
+            if (folded)
+            {
+                EXPECT_TRUE(g->foldConstants());
+                EXPECT_TRUE(g->checkValid());
+                ASSERT_EQ(g->getOperators().size(), 1u);
+                EXPECT_EQ(g->getTensors().size(), 3u);
+                auto weight = mm->getInputs(1);
+                EXPECT_TRUE(weight->isConstant());
+                EXPECT_TRUE(weight->equalData(
+                    vector<float>{0, 4, 8, 1, 5, 9, 2, 6, 10, 3, 7, 11}));
+                EXPECT_FALSE(g->foldConstants());
+            }
+            g->dataMalloc();
+            x->setData(IncrementalGenerator());
+            runtime->run(g);
+        }
+        EXPECT_TRUE(outs[1]->equalData(outs[0]));
+    }
+
+    TEST(Graph, FoldConstantsSkipsUnsupportedTypes)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        // The CPU Add kernel has no Int32 entry point, so the op stays.
+        auto a = g->addTensor({2, 3}, DataType::Int32);
+        auto b = g->addTensor({2, 3}, DataType::Int32);
+        const int32_t values[] = {0, 1, 2, 3, 4, 5};
+        a->setConstant(values);
+        b->setConstant(values);
+        auto add = g->addOp<AddObj>(a, b, nullptr);
+        // A supported op in the same graph is still folded.
+        auto x = g->addTensor({2, 3}, DataType::Float32);
+        x->setConstant(IncrementalGenerator());
+        auto relu = g->addOp<ReluObj>(x, nullptr);
+        EXPECT_TRUE(g->foldConstants());
+        ASSERT_EQ(g->getOperators().size(), 1u);
+        EXPECT_EQ(g->getOperators()[0], add);
+        EXPECT_FALSE(add->getOutput()->isConstant());
+        EXPECT_TRUE(relu->getOutput()->isConstant());
+        EXPECT_TRUE(relu->getOutput()->equalData(
+            vector<float>{0, 1, 2, 3, 4, 5}));
+    }
+
+    TEST(Graph, EliminateCommonSubexpressions)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({2, 3}, DataType::Float32);
+        auto y = g->addTensor({3, 2}, DataType::Float32);
+        // Two identical transposes of x, and two casts of them.
+        auto t0 = g->addOp<TransposeObj>(x, nullptr, Shape{1, 0});
+        auto t1 = g->addOp<TransposeObj>(x, nullptr, Shape{1, 0});
+        auto c0 = g->addOp<CastObj>(t0->getOutput(), nullptr,
+                                    CastType::Float2Float);
+        auto c1 = g->addOp<CastObj>(t1->getOutput(), nullptr,
+                                    CastType::Float2Float);
+        // A transpose of another tensor is not a duplicate.
+        auto t2 = g->addOp<TransposeObj>(y, nullptr, Shape{0, 1});
+        auto add = g->addOp<AddObj>(c0->getOutput(), c1->getOutput(), nullptr);
+        auto sub = g->addOp<SubObj>(add->getOutput(), t2->getOutput(), nullptr);
+        // Nor is a transpose of x with another permutation; its consumer
+        // keeps reading it.
+        auto t3 = g->addOp<TransposeObj>(x, nullptr, Shape{0, 1});
+        auto relu = g->addOp<ReluObj>(t3->getOutput(), nullptr);
+
+        EXPECT_TRUE(g->eliminateCommonSubexpressions());
+        EXPECT_TRUE(g->checkValid());
+        EXPECT_EQ(g->getOperators().size(), 7u);
+        EXPECT_EQ(g->getTensors().size(), 9u);
+        EXPECT_EQ(add->getInputs(0), add->getInputs(1));
+        EXPECT_EQ(add->getInputs(0), c0->getOutput());
+        EXPECT_EQ(sub->getInputs(1), t2->getOutput());
+        EXPECT_TRUE(g->hasOperator(t0));
+        EXPECT_TRUE(g->hasOperator(t3));
+        EXPECT_EQ(relu->getInputs(0), t3->getOutput());
+        EXPECT_FALSE(g->eliminateCommonSubexpressions());
+    }
+
+    TEST(Graph, LinearTimeMutation)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        const int n = 20000;
+        // Build a long chain of Relu in reverse order, so that every op is
+        // added before its producer.
+        TensorVec chain;
+        for (int i = 0; i <= n; ++i)
+            chain.emplace_back(g->addTensor({4}, DataType::Float32));
+        for (int i = n - 1; i >= 0; --i)
+            g->addOpWithOutputs<ReluObj>(chain[i], chain[i + 1]);
+        EXPECT_TRUE(g->topo_sort());
+        const auto &ops = g->getOperators();
+        ASSERT_EQ(ops.size(), (size_t)n);
+        for (int i = 0; i < n; ++i)
+            EXPECT_EQ(ops[i]->getOutput(), chain[i + 1]);
+        EXPECT_EQ(g->getTensor(chain[n]->getFuid()), chain[n]);
+
+        // A tensor read twice by the same op counts both uses.
+        auto x = g->addTensor({4}, DataType::Float32);
+        auto add = g->addOp<AddObj>(x, x, nullptr);
+        EXPECT_EQ(x->getNumTargets(), 2u);
+        EXPECT_EQ(x->getTargets().size(), 2u);
+
+        g->removeOperator(add);
+        g->removeTensor(add->getOutput());
+        EXPECT_FALSE(g->hasOperator(add));
+        EXPECT_EQ(g->getTensor(add->getOutput()->getFuid()), nullptr);
+        EXPECT_EQ(g->getOperators().size(), (size_t)n);
+        EXPECT_EQ(g->getTensors().size(), (size_t)n + 2);
+        // Re-adding a removed tensor does not duplicate it.
+        g->removeTensor(x);
+        g->addTensor(x);
+        EXPECT_EQ(g->getTensors().size(), (size_t)n + 2);
+    }
+
+    TEST(Graph, IncrementalShapeInfer)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({4, 8}, DataType::Float32);
+        auto b = g->addTensor({8}, DataType::Float32);
+        auto x = g->addTensor({2, 6}, DataType::Float32);
+        auto add = g->addOp<AddObj>(a, b, nullptr);
+        auto relu = g->addOp<ReluObj>(add->getOutput(), nullptr);
+        auto other = g->addOp<ReluObj>(x, nullptr);
+        g->dataMalloc();
+
+        // Same byte size: shapes propagate and memory stays in place.
+        auto data = relu->getOutput()->getRawDataPtr<void *>();
+        g->setShape(a, {2, 2, 8});
+        g->shape_infer();
+        EXPECT_EQ(relu->getOutput()->getDims(), (Shape{2, 2, 8}));
+        EXPECT_EQ(other->getOutput()->getDims(), (Shape{2, 6}));
+        EXPECT_EQ(relu->getOutput()->getRawDataPtr<void *>(), data);
+
+        // A larger input makes the graph plan its memory again.
+        g->setShape(a, {32, 8});
+        g->shape_infer();
+        EXPECT_EQ(relu->getOutput()->getDims(), (Shape{32, 8}));
+        a->setData(IncrementalGenerator());
+        b->setData(OneGenerator());
+        x->setData(OneGenerator());
+        runtime->run(g);
+        vector<float> ans(256);
+        for (size_t i = 0; i < ans.size(); ++i)
+            ans[i] = i + 1;
+        EXPECT_TRUE(relu->getOutput()->equalData(ans));
+    }
+
+    TEST(Graph, ShapeInferDirectInputReshape)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({1, 4}, DataType::Float32);
+        auto y = g->addTensor({3, 4}, DataType::Float32);
+        auto add = g->addOp<AddObj>(x, y, nullptr);
+        g->dataMalloc();
+        g->setCaptureMode(true);
+        auto plan = g->getCapturedPlan();
+
+        // The output keeps its shape, but the plan and the arena slot of x
+        // are stale.
+        x->setShape({3, 4});
+        g->shape_infer();
+        EXPECT_EQ(add->getOutput()->getDims(), (Shape{3, 4}));
+        EXPECT_NE(g->getCapturedPlan(), plan);
+        x->setData(IncrementalGenerator());
+        y->setData(OneGenerator());
+        runtime->run(g);
+        vector<float> ans(12);
+        for (size_t i = 0; i < ans.size(); ++i)
+            ans[i] = i + 1;
+        EXPECT_TRUE(add->getOutput()->equalData(ans));
+    }
+
+    TEST(Graph, CostModel)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({8, 16}, DataType::Float32);
+        auto b = g->addTensor({16, 4}, DataType::Float32);
+        auto mm = g->addOp<MatmulObj>(a, b, nullptr);
+        auto relu = g->addOp<ReluObj>(mm->getOutput(), nullptr);
+        auto trans = g->addOp<TransposeObj>(relu->getOutput(), nullptr,
+                                            Shape{1, 0});
+        EXPECT_EQ(mm->getFlops(), 2 * 8 * 4 * 16);
+        EXPECT_EQ(mm->getBytesRead(), (8 * 16 + 16 * 4) * 4);
+        EXPECT_EQ(mm->getBytesWritten(), 8 * 4 * 4);
+        EXPECT_DOUBLE_EQ(mm->getArithmeticIntensity(), 1024. / 896);
+        EXPECT_EQ(relu->getFlops(), 32);
+        EXPECT_EQ(trans->getFlops(), 0);
+        EXPECT_EQ(g->getFlops(), 1024 + 32);
+        EXPECT_EQ(g->getBytesMoved(), 896 + 256 + 256);
+
+        // With a ridge point of 1 FLOP/B only the MatMul is compute bound.
+        auto report = g->rooflineReport(10, 10);
+        EXPECT_NE(report.find("MatMul"), string::npos);
+        EXPECT_NE(report.find("compute"), string::npos);
+        EXPECT_NE(report.find("memory"), string::npos);
+        EXPECT_NE(report.find("Total"), string::npos);
+
+        // Folding the Relu into the MatMul saves the intermediate traffic.
+        EXPECT_TRUE(g->fuseMatmulEpilogue());
+        EXPECT_EQ(g->getFlops(), 1024 + 32);
+        EXPECT_EQ(g->getBytesMoved(), 896 + 256);
+    }
+}
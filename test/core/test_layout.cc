@@ -0,0 +1,133 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "core/serialize.h"
+#include "operators/matmul.h"
+#include "operators/reorder.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(Layout, ChooseLayouts)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        // A reference graph and one to choose layouts for, both computing
+        // x * w, x * v^T + b with w, v and b constant, and x * s, y^T * s.
+        Graph graphs[2];
+        TensorVec results[2];
+        for (int i = 0; i < 2; ++i)
+        {
+            Graph g = graphs[i] = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({16, 12}, DataType::Float32);
+            auto y = g->addTensor({12, 16}, DataType::Float32);
+            auto s = g->addTensor({12, 20}, DataType::Float32);
+            auto w = g->addTensor({12, 20}, DataType::Float32);
+            auto v = g->addTensor({20, 12}, DataType::Float32);
+            auto b = g->addTensor({20}, DataType::Float32);
+            w->setConstant(IncrementalGenerator());
+            v->setConstant(IncrementalGenerator());
+            b->setConstant(OneGenerator());
+            auto xw = g->addOp<MatmulObj>(x, w, nullptr)->getOutput();
+            auto xv = g->addOp<MatmulObj>(x, v, nullptr, false, true, b)
+                          ->getOutput();
+            auto xs = g->addOp<MatmulObj>(x, s, nullptr)->getOutput();
+            auto yts = g->addOp<MatmulObj>(y, s, nullptr, true)->getOutput();
+            results[i] = {xw, xv, xs, yts};
+        }
+        Graph ref = graphs[0], g = graphs[1];
+        const TensorVec &ans = results[0], &outputs = results[1];
+        auto setInputs = [](const Graph &graph)
+        {
+            for (const auto &input : graph->getInputs())
+                if (!input->isConstant())
+                    input->setData(IncrementalGenerator());
+        };
+        EXPECT_THROW(g->chooseLayouts(4), Exception);
+        EXPECT_TRUE(g->chooseLayouts(8));
+        EXPECT_FALSE(g->chooseLayouts(8));
+
+        // Constants were packed in place of the originals; the input is
+        // packed by a single Reorder shared by both of its readers.
+        int reorders = 0, blocked = 0;
+        for (const auto &op : g->getOperators())
+            reorders += op->getOpType() == OpType::Reorder;
+        for (const auto &tensor : g->getTensors())
+            blocked += tensor->isBlocked();
+        EXPECT_EQ(reorders, 1);
+        EXPECT_EQ(blocked, 3);
+        EXPECT_EQ(g->getTensors().size(), ref->getTensors().size() + 1);
+        auto matmul = as<MatmulObj>(outputs[1]->getSource());
+        EXPECT_FALSE(matmul->getTransB());
+        EXPECT_EQ(matmul->getInputs(1)->getBlock(), 8);
+        // The last block of the 20 columns is padded to 24.
+        EXPECT_EQ(matmul->getInputs(1)->getBytes(), 12 * 24 * sizeof(float));
+        EXPECT_TRUE(g->checkValid());
+
+        ref->dataMalloc();
+        setInputs(ref);
+        runtime->run(ref);
+
+        // Every candidate reads blocked operands.
+        const string path = "test_layout_graph.bin";
+        saveGraph(g, path);
+        Graph loaded = loadGraph(runtime, path);
+        std::remove(path.c_str());
+        for (const auto &graph : {g, loaded})
+            for (const auto &candidate :
+                 KernelRegistry::getInstance().getKernelItems(
+                     {Device::CPU, OpType::MatMul}))
+            {
+                vector<string> kernels;
+                for (const auto &op : graph->getOperators())
+                    kernels.emplace_back(op->getOpType() == OpType::MatMul
+                                             ? std::get<1>(candidate)
+                                             : "Reorder_CPU");
+                graph->dataMalloc();
+                setInputs(graph);
+                runtime->run(graph->compile(kernels));
+                auto results = graph->getOutputs();
+                ASSERT_EQ(results.size(), ans.size());
+                for (size_t i = 0; i < ans.size(); ++i)
+                    EXPECT_TRUE(results[i]->equalData(ans[i]))
+                        << std::get<1>(candidate) << " output " << i;
+            }
+    }
+
+    TEST(Layout, SkipsEmptyMatmuls)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({16, 12}, DataType::Float32);
+        auto s = g->addTensor({12, 0}, DataType::Float32);
+        auto w = g->addTensor({12, 0}, DataType::Float32);
+        w->setConstant();
+        g->addOp<MatmulObj>(x, s, nullptr);
+        g->addOp<MatmulObj>(x, w, nullptr);
+        EXPECT_FALSE(g->chooseLayouts(8));
+        EXPECT_EQ(g->getOperators().size(), 2u);
+    }
+
+    TEST(Layout, Reorder)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({2, 3, 5}, DataType::UInt32);
+        auto packed = g->addOp<ReorderObj>(x, nullptr, 4)->getOutput();
+        auto plain = g->addOp<ReorderObj>(packed, nullptr, 0)->getOutput();
+        EXPECT_EQ(packed->getBlock(), 4);
+        EXPECT_EQ(packed->getPhysicalSize(), 2u * 2 * 3 * 4);
+        g->dataMalloc();
+        x->setData(IncrementalGenerator());
+        runtime->run(g);
+
+        // Two panels of [3, 4] per matrix, the second one half padding.
+        auto data = packed->getRawDataPtr<uint32_t *>();
+        vector<uint32_t> firstMatrix(data, data + 24);
+        EXPECT_EQ(firstMatrix,
+                  (vector<uint32_t>{0, 1, 2, 3, 5, 6, 7, 8, 10, 11, 12, 13,
+                                    4, 0, 0, 0, 9, 0, 0, 0, 14, 0, 0, 0}));
+        EXPECT_TRUE(plain->equalData(x));
+    }
+
+} // namespace infini
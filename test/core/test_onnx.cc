@@ -0,0 +1,140 @@
+#include "core/onnx.h"
+#include "core/runtime.h"
+
+#include "test.h"
+#include <cstring>
+#include <fstream>
+
+namespace infini
+{
+    // Builds protobuf messages field by field.
+    struct Proto
+    {
+        string bytes;
+
+        void key(int field, int wireType)
+        {
+            raw((uint64_t)field << 3 | wireType);
+        }
+        void raw(uint64_t v)
+        {
+            for (; v >= 0x80; v >>= 7)
+                bytes.push_back(char(v | 0x80));
+            bytes.push_back(char(v));
+        }
+        Proto &varint(int field, uint64_t v)
+        {
+            key(field, 0);
+            raw(v);
+            return *this;
+        }
+        Proto &str(int field, const string &s)
+        {
+            key(field, 2);
+            raw(s.size());
+            bytes += s;
+            return *this;
+        }
+        Proto &msg(int field, const Proto &m) { return str(field, m.bytes); }
+        Proto &f32(int field, float f)
+        {
+            key(field, 5);
+            bytes.append(reinterpret_cast<const char *>(&f), sizeof(f));
+            return *this;
+        }
+    };
+
+    static Proto valueInfo(const string &name, vector<Proto> dims)
+    {
+        Proto shape, tensor, type;
+        for (const auto &dim : dims)
+            shape.msg(1, dim);
+        tensor.varint(1, 1).msg(2, shape);
+        type.msg(1, tensor);
+        return Proto().str(1, name).msg(2, type);
+    }
+
+    static Proto node(const string &type, vector<string> inputs,
+                      const string &output, vector<Proto> attrs = {})
+    {
+        Proto n;
+        for (const auto &input : inputs)
+            n.str(1, input);
+        n.str(2, output).str(4, type);
+        for (const auto &attr : attrs)
+            n.msg(5, attr);
+        return n;
+    }
+
+    TEST(Onnx, Import)
+    {
+        // t = Transpose(Clip(Mul(Relu(Gemm(x, w, b)), c), max = 20))
+        vector<float> w(12), b{1, -100, 2};
+        for (size_t i = 0; i < w.size(); ++i)
+            w[i] = i;
+        Proto wInit, bInit, cValue, packedPerm;
+        wInit.varint(1, 4).varint(1, 3).varint(2, 1).str(8, "w").str(
+            9, string(reinterpret_cast<const char *>(w.data()), 48));
+        packedPerm.raw(1);
+        packedPerm.raw(0);
+        bInit.varint(1, 3).varint(2, 1).str(8, "b");
+        for (float v : b)
+            bInit.f32(4, v);
+        cValue.varint(1, 1).varint(2, 1).f32(4, 2.f);
+        Proto maxInit;
+        maxInit.varint(2, 1).str(8, "max").f32(4, 20.f);
+
+        Proto graph;
+        graph.msg(1, node("Gemm", {"x", "w", "b"}, "y"))
+            .msg(1, node("Relu", {"y"}, "r"))
+            .msg(1, node("Constant", {}, "c",
+                         {Proto().str(1, "value").msg(5, cValue)}))
+            .msg(1, node("Mul", {"r", "c"}, "m"))
+            .msg(1, node("Clip", {"m", "", "max"}, "clip"))
+            .msg(1, node("Transpose", {"clip"}, "t",
+                         {Proto().str(1, "perm").msg(8, packedPerm)}))
+            .str(2, "test")
+            .msg(5, wInit)
+            .msg(5, bInit)
+            .msg(5, maxInit)
+            .msg(11, valueInfo("x", {Proto().str(2, "batch"),
+                                     Proto().varint(1, 4)}))
+            .msg(12, valueInfo("t", {}));
+        Proto model;
+        model.varint(1, 8).msg(7, graph);
+
+        const string path = "test_onnx_model.onnx";
+        std::ofstream(path, std::ios::binary) << model.bytes;
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto imported = importOnnx(runtime, path, {{"batch", 2}});
+        std::remove(path.c_str());
+
+        auto g = imported.graph;
+        ASSERT_EQ(imported.inputs.size(), 1u);
+        ASSERT_EQ(imported.outputs.size(), 1u);
+        auto x = imported.inputs[0];
+        auto t = imported.outputs[0];
+        EXPECT_EQ(x->getDims(), (Shape{2, 4}));
+        EXPECT_EQ(t->getDims(), (Shape{3, 2}));
+        EXPECT_TRUE(imported.tensors.at("w")->isConstant());
+        EXPECT_EQ(g->getOperators().size(), 5u);
+        EXPECT_TRUE(g->checkValid());
+
+        g->dataMalloc();
+        vector<float> input{1, 0, 0, 1, 0, 1, 1, 0};
+        x->setData([&](void *ptr, size_t size, DataType)
+                   { std::memcpy(ptr, input.data(), size * sizeof(float)); });
+        runtime->run(g);
+        vector<float> ans(6);
+        for (int i = 0; i < 2; ++i)
+            for (int j = 0; j < 3; ++j)
+            {
+                float sum = b[j];
+                for (int k = 0; k < 4; ++k)
+                    sum += input[i * 4 + k] * w[k * 3 + j];
+                ans[j * 2 + i] = std::min(std::max(sum, 0.f) * 2, 20.f);
+            }
+        EXPECT_TRUE(t->equalData(ans));
+    }
+
+} // namespace infini
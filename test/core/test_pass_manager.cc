@@ -0,0 +1,81 @@
+#include "core/graph.h"
+#include "core/pass_manager.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(PassManager, RunsToFixpointWithStats)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({8, 16}, DataType::Float32);
+        auto y = g->addTensor({16, 8}, DataType::Float32);
+        // Two identical transposes that only become one after CSE, then an
+        // element-wise chain to fuse.
+        auto t0 = g->addOp<TransposeObj>(x, nullptr, Shape{1, 0});
+        auto t1 = g->addOp<TransposeObj>(x, nullptr, Shape{1, 0});
+        auto add = g->addOp<AddObj>(t0->getOutput(), t1->getOutput(), nullptr);
+        auto mul = g->addOp<MulObj>(add->getOutput(), y, nullptr);
+        auto relu = g->addOp<ReluObj>(mul->getOutput(), nullptr);
+
+        PassManager passes;
+        EXPECT_TRUE(passes.run(*g));
+        EXPECT_TRUE(g->checkValid());
+        EXPECT_EQ(g->getOperators().size(), 2u);
+        EXPECT_EQ(relu->getOutput()->getSource()->getOpType(),
+                  OpType::FusedElementWise);
+        EXPECT_GE(passes.getIterations(), 2);
+
+        const auto &stats = passes.getStats();
+        ASSERT_EQ(stats.size(), PassManager::defaultPipeline().size());
+        for (const auto &stat : stats)
+        {
+            EXPECT_EQ(stat.runs, passes.getIterations());
+            if (stat.name == "cse")
+            {
+                EXPECT_EQ(stat.changes, 1);
+                EXPECT_EQ(stat.opsRemoved, 1);
+                EXPECT_EQ(stat.tensorsRemoved, 1);
+                EXPECT_EQ(stat.bytesSaved, 2 * 128 * 4);
+            }
+            if (stat.name == "fuse-element-wise")
+            {
+                EXPECT_EQ(stat.opsRemoved, 2);
+                EXPECT_EQ(stat.tensorsRemoved, 2);
+                EXPECT_GT(stat.bytesSaved, 0);
+                EXPECT_EQ(stat.flopsSaved, 0);
+            }
+        }
+        EXPECT_NE(passes.summary().find("fuse-element-wise"), string::npos);
+        EXPECT_FALSE(passes.run(*g));
+    }
+
+    TEST(PassManager, CustomPipeline)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({4}, DataType::Float32);
+        auto relu = g->addOp<ReluObj>(x, nullptr);
+        g->addOp<ReluObj>(relu->getOutput(), nullptr);
+
+        PassManager cseOnly({"cse"});
+        EXPECT_FALSE(cseOnly.run(*g));
+        EXPECT_EQ(g->getOperators().size(), 2u);
+        EXPECT_EQ(cseOnly.getIterations(), 1);
+
+        // Reports a change on its first two runs.
+        static int calls = 0;
+        PassRegistry::getInstance().registerPass(
+            "test-count", [](GraphObj &) { return ++calls < 3; });
+        PassManager counting({"test-count"});
+        EXPECT_TRUE(counting.run(*g));
+        EXPECT_EQ(calls, 3);
+        EXPECT_EQ(counting.getStats()[0].changes, 2);
+    }
+
+} // namespace infini
@@ -0,0 +1,78 @@
+#include "core/graph.h"
+#include "core/plan.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(ExecutionPlan, MatchesGraphRun)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto i0 = g->addTensor({2, 3, 4}, DataType::Float32);
+        auto i1 = g->addTensor({3, 1}, DataType::Float32);
+        auto sub = g->addOp<SubObj>(i0, i1, nullptr);
+        auto relu = g->addOp<ReluObj>(sub->getOutput(), nullptr);
+        auto trans = g->addOp<TransposeObj>(relu->getOutput(), nullptr,
+                                            vector<int>{2, 0, 1});
+        g->dataMalloc();
+        i0->setData(IncrementalGenerator());
+        i1->setData(IncrementalGenerator());
+
+        auto plan = g->compile();
+        EXPECT_EQ(plan->size(), 3u);
+        const auto &records = plan->getRecords();
+        EXPECT_EQ(records[0].opType, OpType::Sub);
+        EXPECT_EQ(records[2].outputs[0].data,
+                  trans->getOutput()->getRawDataPtr<void *>());
+        EXPECT_EQ(records[2].outputs[0].dims[0], 4);
+
+        runtime->run(plan);
+        vector<float> ans(trans->getOutput()->size());
+        std::copy_n(trans->getOutput()->getRawDataPtr<float *>(), ans.size(),
+                    ans.begin());
+
+        runtime->run(g);
+        EXPECT_TRUE(trans->getOutput()->equalData(ans));
+        // i0 - i1 at (b=1, c=2, k=3) is 23 - 2, stored transposed at (3, 1, 2)
+        EXPECT_EQ(ans[3 * 6 + 1 * 3 + 2], 21.f);
+    }
+
+    TEST(ExecutionPlan, CaptureAndReplay)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto i0 = g->addTensor({4, 8}, DataType::Float32);
+        auto i1 = g->addTensor({8}, DataType::Float32);
+        auto add = g->addOp<AddObj>(i0, i1, nullptr);
+        auto relu = g->addOp<ReluObj>(add->getOutput(), nullptr);
+        g->dataMalloc();
+        i0->setData(IncrementalGenerator());
+        i1->setData(OneGenerator());
+
+        g->setCaptureMode(true);
+        runtime->run(g);
+        auto plan = g->getCapturedPlan();
+        EXPECT_EQ(plan->size(), 2u);
+        EXPECT_NE(plan->getRecords()[0].func, nullptr);
+
+        // Replays reuse the captured plan and see new input data.
+        i1->setData(ZeroGenerator());
+        runtime->run(g);
+        EXPECT_EQ(g->getCapturedPlan(), plan);
+        vector<float> ans(32);
+        for (size_t i = 0; i < ans.size(); ++i)
+            ans[i] = i;
+        EXPECT_TRUE(relu->getOutput()->equalData(ans));
+
+        // A shape change seen by shape_infer drops the capture.
+        i0->setShape({2, 8});
+        g->shape_infer();
+        EXPECT_NE(g->getCapturedPlan(), plan);
+    }
+
+} // namespace infini
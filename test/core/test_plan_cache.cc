@@ -0,0 +1,132 @@
+#include "core/plan_cache.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+
+#include "test.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace infini
+{
+    TEST(PlanCache, WarmStart)
+    {
+        // out = Relu(MatMul(x, w) + b)
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({8, 16}, DataType::Float32);
+        auto w = g->addTensor({16, 8}, DataType::Float32);
+        auto b = g->addTensor({8}, DataType::Float32);
+        w->setConstant(IncrementalGenerator());
+        b->setConstant(OneGenerator());
+        auto mm = g->addOp<MatmulObj>(x, w, nullptr);
+        auto add = g->addOp<AddObj>(mm->getOutput(), b, nullptr);
+        auto out = g->addOp<ReluObj>(add->getOutput(), nullptr)->getOutput();
+        g->optimize();
+        g->dataMalloc();
+        auto plan = g->compile();
+
+        const string directory = "test_plan_cache.d";
+        const auto hash = PlanCache::modelHash(g);
+        EXPECT_EQ(hash.size(), 16u);
+        {
+            PlanCache cache(directory);
+            EXPECT_FALSE(cache.load(runtime, hash).has_value());
+            cache.store(hash, g, plan);
+            // Storing again replaces the entry and leaves no temporary
+            // files behind.
+            cache.store(hash, g, plan);
+            int graphs = 0, plans = 0, others = 0;
+            for (const auto &file :
+                 std::filesystem::directory_iterator(directory))
+            {
+                auto ext = file.path().extension();
+                graphs += ext == ".graph";
+                plans += ext == ".plan";
+                others += ext != ".graph" && ext != ".plan";
+            }
+            EXPECT_EQ(graphs, 1);
+            EXPECT_EQ(plans, 1);
+            EXPECT_EQ(others, 0);
+        }
+
+        PlanCache cache(directory);
+        auto entry = cache.load(runtime, hash);
+        EXPECT_FALSE(cache.load(runtime, "another model").has_value());
+        std::filesystem::remove_all(directory);
+        ASSERT_TRUE(entry.has_value());
+        auto loaded = entry->graph;
+        ASSERT_EQ(loaded->getOperators().size(), g->getOperators().size());
+        ASSERT_EQ(entry->plan->size(), plan->size());
+        EXPECT_EQ(loaded->getMemoryPlan().offsets,
+                  g->getMemoryPlan().offsets);
+        EXPECT_EQ(PlanCache::modelHash(loaded), hash);
+        for (size_t i = 0; i < plan->size(); ++i)
+            EXPECT_STREQ(entry->plan->getRecords()[i].kernelName,
+                         plan->getRecords()[i].kernelName);
+
+        // Tensors keep their order, so the input is found by position.
+        const auto &tensors = g->getTensors();
+        auto pos =
+            std::find(tensors.begin(), tensors.end(), x) - tensors.begin();
+        x->setData(IncrementalGenerator());
+        loaded->getTensors()[pos]->setData(IncrementalGenerator());
+        runtime->run(plan);
+        runtime->run(entry->plan);
+        auto outputs = loaded->getOutputs();
+        ASSERT_EQ(outputs.size(), 1u);
+        EXPECT_TRUE(outputs[0]->equalData(out));
+    }
+
+    TEST(PlanCache, ReplacesAndRejectsStaleEntries)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        const string directory = "test_plan_cache_stale.d";
+        PlanCache cache(directory);
+        auto countGraphs = [&]
+        {
+            int graphs = 0;
+            for (const auto &file :
+                 std::filesystem::directory_iterator(directory))
+                graphs += file.path().extension() == ".graph";
+            return graphs;
+        };
+
+        // Two different graphs stored under one model hash: the second
+        // replaces the first, graph file included.
+        for (int relus = 1; relus <= 2; ++relus)
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            Tensor x = g->addTensor({4}, DataType::Float32);
+            for (int i = 0; i < relus; ++i)
+                x = g->addOp<ReluObj>(x, nullptr)->getOutput();
+            g->dataMalloc();
+            cache.store("model", g, g->compile());
+            EXPECT_EQ(countGraphs(), 1);
+        }
+        auto entry = cache.load(runtime, "model");
+        ASSERT_TRUE(entry.has_value());
+        EXPECT_EQ(entry->graph->getOperators().size(), 2u);
+
+        // An entry naming a kernel that no longer exists is a miss.
+        string planPath;
+        for (const auto &file : std::filesystem::directory_iterator(directory))
+            if (file.path().extension() == ".plan")
+                planPath = file.path().string();
+        std::stringstream text;
+        {
+            std::ifstream ifs(planPath);
+            text << ifs.rdbuf();
+        }
+        auto plan = text.str();
+        auto pos = plan.find("reluNaive_CPU");
+        ASSERT_NE(pos, string::npos);
+        plan.replace(pos, 13, "removed_CPU");
+        std::ofstream(planPath) << plan;
+        EXPECT_FALSE(cache.load(runtime, "model").has_value());
+        std::filesystem::remove_all(directory);
+    }
+
+} // namespace infini
@@ -0,0 +1,98 @@
+#include "core/graph.h"
+#include "core/plan.h"
+#include "core/profiler.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/unary.h"
+
+#include "test.h"
+#include <filesystem>
+
+namespace infini
+{
+    TEST(Profiler, RecordsPerOpEvents)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto i0 = g->addTensor({16, 16}, DataType::Float32);
+        auto i1 = g->addTensor({16, 16}, DataType::Float32);
+        auto mul = g->addOp<MulObj>(i0, i1, nullptr);
+        auto relu = g->addOp<ReluObj>(mul->getOutput(), nullptr);
+        g->dataMalloc();
+        i0->setData(IncrementalGenerator());
+        i1->setData(OneGenerator());
+
+        auto &profiler = Profiler::getInstance();
+        profiler.clear();
+        runtime->run(g);
+        EXPECT_TRUE(profiler.getEvents().empty());
+
+        profiler.enable();
+        runtime->run(g);
+        profiler.disable();
+        const auto &events = profiler.getEvents();
+        ASSERT_EQ(events.size(), 2u);
+        EXPECT_EQ(events[0].guid, mul->getGuid());
+        EXPECT_EQ(string(events[0].kernelName), "mulNaive_CPU");
+        EXPECT_EQ(events[0].bytesRead, 2 * 256 * sizeof(float));
+        EXPECT_EQ(events[0].bytesWritten, 256 * sizeof(float));
+        EXPECT_EQ(events[1].guid, relu->getGuid());
+        EXPECT_EQ(events[1].flops, 256u);
+
+        // Estimates follow the shapes a record was lowered with, not the
+        // current shapes of its operator.
+        auto plan = g->compile();
+        i0->setShape({8, 16});
+        i1->setShape({8, 16});
+        g->shape_infer();
+        EXPECT_EQ(relu->getFlops(), 128);
+        EXPECT_EQ(Profiler::estimateFlops(plan->getRecords()[1]), 256u);
+
+        auto table = profiler.summary();
+        EXPECT_NE(table.find("Mul"), string::npos);
+        EXPECT_NE(table.find("Relu"), string::npos);
+
+        const string path = (std::filesystem::temp_directory_path() /
+                             "infini_test_profiler_trace.json")
+                                .string();
+        profiler.dumpChromeTrace(path);
+        std::stringstream trace;
+        {
+            std::ifstream ifs(path);
+            trace << ifs.rdbuf();
+        }
+        std::remove(path.c_str());
+        EXPECT_NE(trace.str().find("\"traceEvents\""), string::npos);
+        EXPECT_NE(trace.str().find("reluNaive_CPU"), string::npos);
+        profiler.clear();
+    }
+
+    TEST(Profiler, HardwareCounters)
+    {
+        auto &profiler = Profiler::getInstance();
+        if (!profiler.enableHardwareCounters())
+            GTEST_SKIP() << "perf_event_open is not available";
+
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto i0 = g->addTensor({64, 64}, DataType::Float32);
+        auto relu = g->addOp<ReluObj>(i0, nullptr);
+        g->dataMalloc();
+        i0->setData(IncrementalGenerator());
+
+        profiler.clear();
+        profiler.enable();
+        runtime->run(g);
+        profiler.disable();
+        profiler.disableHardwareCounters();
+        ASSERT_EQ(profiler.getEvents().size(), 1u);
+        const auto &event = profiler.getEvents()[0];
+        EXPECT_EQ(event.guid, relu->getGuid());
+        EXPECT_TRUE(event.hasCounters);
+        EXPECT_GT(event.counters.instructions, 0u);
+        EXPECT_NE(profiler.counterReport().find("reluNaive_CPU"),
+                  string::npos);
+        profiler.clear();
+    }
+
+} // namespace infini
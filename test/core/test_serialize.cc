@@ -0,0 +1,77 @@
+#include "core/runtime.h"
+#include "core/serialize.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(Serialize, SaveAndLoad)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        // t = Transpose(Clip(MatMul(x, w^T) + bias, 0, 100)),
+        // out = Concat(t, Cast(Relu(x - t)))
+        auto x = g->addTensor({4, 4}, DataType::Float32);
+        auto w = g->addTensor({4, 4}, DataType::Float32);
+        auto bias = g->addTensor({4}, DataType::Float32);
+        w->setConstant(IncrementalGenerator());
+        bias->setConstant(OneGenerator());
+        auto mm = g->addOp<MatmulObj>(x, w, nullptr, false, true, bias);
+        mm->setClamp(0, 100);
+        auto trans =
+            g->addOp<TransposeObj>(mm->getOutput(), nullptr, Shape{1, 0});
+        auto sub = g->addOp<SubObj>(x, trans->getOutput(), nullptr);
+        auto relu = g->addOp<ReluObj>(sub->getOutput(), nullptr);
+        auto cast = g->addOp<CastObj>(relu->getOutput(), nullptr,
+                                      CastType::Float2Float);
+        auto out = g->addOp<ConcatObj>(TensorVec{trans->getOutput(),
+                                                 cast->getOutput()},
+                                       nullptr, 0)
+                       ->getOutput();
+        g->fuseElementWise();
+        const string path = "test_serialize_graph.bin";
+        saveGraph(g, path);
+
+        Graph loaded = loadGraph(runtime, path);
+        std::remove(path.c_str());
+        ASSERT_EQ(loaded->getOperators().size(), g->getOperators().size());
+        ASSERT_EQ(loaded->getTensors().size(), g->getTensors().size());
+        EXPECT_TRUE(loaded->checkValid());
+        for (size_t i = 0; i < g->getOperators().size(); ++i)
+            EXPECT_EQ(loaded->getOperators()[i]->getOpAttrVector(),
+                      g->getOperators()[i]->getOpAttrVector());
+
+        // Constants refer to aligned pages of the mapped file, which stay
+        // mapped after the file is removed.
+        int constants = 0;
+        for (const auto &tensor : loaded->getTensors())
+            if (tensor->isConstant())
+            {
+                ++constants;
+                EXPECT_EQ((uintptr_t)tensor->getRawDataPtr<void *>() % 64, 0u);
+            }
+        EXPECT_EQ(constants, 2);
+
+        g->dataMalloc();
+        loaded->dataMalloc();
+        // Tensors keep their order, so the input is found by position.
+        const auto &tensors = g->getTensors();
+        auto pos =
+            std::find(tensors.begin(), tensors.end(), x) - tensors.begin();
+        auto input = loaded->getTensors()[pos];
+        EXPECT_EQ(input->getDims(), x->getDims());
+        x->setData(IncrementalGenerator());
+        input->setData(IncrementalGenerator());
+        runtime->run(g);
+        runtime->run(loaded);
+        auto outputs = loaded->getOutputs();
+        ASSERT_EQ(outputs.size(), 1u);
+        EXPECT_TRUE(outputs[0]->equalData(out));
+    }
+
+} // namespace infini
@@ -0,0 +1,97 @@
+#include "core/graph.h"
+#include "core/plan.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(TensorView, TransposeAsView)
+    {
+        // out = Transpose(x)^T + y, relu = Relu(Transpose(x))
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({2, 3, 4}, DataType::Float32);
+        auto y = g->addTensor({2, 3, 4}, DataType::Float32);
+        auto t1 = g->addOp<TransposeObj>(x, nullptr, Shape{0, 2, 1});
+        auto t2 = g->addOp<TransposeObj>(t1->getOutput(), nullptr,
+                                         Shape{0, 2, 1});
+        auto out = g->addOp<AddObj>(t2->getOutput(), y, nullptr)->getOutput();
+        auto t3 = g->addOp<TransposeObj>(x, nullptr, Shape{2, 0, 1});
+        auto relu = g->addOp<ReluObj>(t3->getOutput(), nullptr)->getOutput();
+        g->dataMalloc();
+
+        // Both transposes feeding Add read x in place; the one feeding Relu
+        // is materialized because Relu reads dense inputs only.
+        auto v1 = t1->getOutput(), v2 = t2->getOutput();
+        ASSERT_TRUE(v1->isView());
+        EXPECT_FALSE(v1->isContiguous());
+        EXPECT_EQ(v1->getStrides(), (vector<size_t>{12, 1, 4}));
+        EXPECT_EQ(v1->getRawDataPtr<void *>(), x->getRawDataPtr<void *>());
+        ASSERT_TRUE(v2->isView());
+        EXPECT_TRUE(v2->isContiguous());
+        EXPECT_TRUE(t1->producesView() && t2->producesView());
+        EXPECT_FALSE(t3->getOutput()->isView());
+        EXPECT_FALSE(out->isView());
+
+        vector<float> xs(24), ys(24), sum(24), ans(24);
+        for (size_t i = 0; i < xs.size(); ++i)
+        {
+            xs[i] = i;
+            ys[i] = 100.f * i;
+            sum[i] = xs[i] + ys[i];
+        }
+        for (int a = 0; a < 2; ++a)
+            for (int b = 0; b < 3; ++b)
+                for (int c = 0; c < 4; ++c)
+                    ans[c * 6 + a * 3 + b] = xs[a * 12 + b * 4 + c];
+        auto fill = [](const vector<float> &values)
+        {
+            return [&values](void *ptr, size_t size, DataType)
+            { std::copy_n(values.data(), size, static_cast<float *>(ptr)); };
+        };
+        x->setData(fill(xs));
+        y->setData(fill(ys));
+        runtime->run(g);
+        EXPECT_TRUE(out->equalData(sum));
+        EXPECT_TRUE(relu->equalData(ans));
+        EXPECT_TRUE(x->equalData(xs));
+
+        // Reshaping ends the view, and the next allocation recomputes it.
+        g->setShape(x, {4, 3, 2});
+        g->setShape(y, {4, 2, 3});
+        g->shape_infer();
+        EXPECT_TRUE(v1->isView());
+        EXPECT_EQ(v1->getStrides(), (vector<size_t>{6, 1, 2}));
+    }
+
+    TEST(TensorView, StridedTransposeKernels)
+    {
+        // A materialized transpose that reads a view.
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        for (const string kernel : {"TransposeNaive_CPU", "TransposeTiled_CPU"})
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({40, 3, 50}, DataType::Float32);
+            auto view = g->addOp<TransposeObj>(x, nullptr, Shape{1, 2, 0});
+            auto t = g->addOp<TransposeObj>(view->getOutput(), nullptr,
+                                            Shape{2, 1, 0});
+            g->dataMalloc();
+            ASSERT_TRUE(view->getOutput()->isView());
+            x->setData(IncrementalGenerator());
+            runtime->run(g->compile({kernel, kernel}));
+
+            // t[i][j][k] = view[k][j][i] = x[i][k][j]
+            vector<float> ans(t->getOutput()->size());
+            for (int i = 0; i < 40; ++i)
+                for (int j = 0; j < 50; ++j)
+                    for (int k = 0; k < 3; ++k)
+                        ans[(i * 50 + j) * 3 + k] = i * 150 + k * 50 + j;
+            EXPECT_TRUE(t->getOutput()->equalData(ans));
+        }
+    }
+
+} // namespace infini
@@ -0,0 +1,37 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini {
+
+// Casts Float32 data to `type` and back, which has to reproduce `ansVec`.
+void testCastRoundTrip(CastType type, CastType back, const vector<float> &data,
+                       const vector<float> &ansVec) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto input = g->addTensor({(int)data.size()}, DataType::Float32);
+    auto cast = g->addOp<CastObj>(input, nullptr, type);
+    auto output = g->addOp<CastObj>(cast->getOutput(), nullptr, back);
+    g->dataMalloc();
+    input->setData([&](void *ptr, size_t size, DataType) {
+        std::copy(data.begin(), data.end(), reinterpret_cast<float *>(ptr));
+    });
+    runtime->run(g);
+    EXPECT_TRUE(output->getOutput()->equalData(ansVec));
+}
+
+TEST(Cast, NativeCpu) {
+    testCastRoundTrip(CastType::Float2Int32, CastType::Int322Float,
+                      {-2.5f, 0.f, 3.75f, 1e6f}, {-2.f, 0.f, 3.f, 1e6f});
+    testCastRoundTrip(CastType::Float2Float16, CastType::Float162Float,
+                      {-2.5f, 1.f / 3, 65504.f, 1e-7f, 1e5f},
+                      {-2.5f, 0.333251953125f, 65504.f, 1.192092896e-7f,
+                       INFINITY});
+    testCastRoundTrip(CastType::Float2BFloat16, CastType::BFloat162Float,
+                      {-2.5f, 1.f / 3, 3e38f},
+                      {-2.5f, 0.333984375f, 3.00405527e38f});
+}
+
+} // namespace infini
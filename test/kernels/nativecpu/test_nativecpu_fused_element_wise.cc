@@ -0,0 +1,119 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/fused_element_wise.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini {
+
+// out = Cast(Mul(Clip(Relu(Sub(b, a)), max = 100), x)), with a and b
+// broadcast to the output shape.
+Tensor buildChain(const Graph &g, const Tensor &a, const Tensor &b,
+                  const Tensor &x) {
+    auto sub = g->addOp<SubObj>(b, a, nullptr);
+    auto relu = g->addOp<ReluObj>(sub->getOutput(), nullptr);
+    auto clip = g->addOp<ClipObj>(relu->getOutput(), nullptr, std::nullopt,
+                                  100.f);
+    auto mul = g->addOp<MulObj>(clip->getOutput(), x, nullptr);
+    auto cast =
+        g->addOp<CastObj>(mul->getOutput(), nullptr, CastType::Float2Float);
+    return cast->getOutput();
+}
+
+TEST(FusedElementWise, NativeCpu) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Tensor outputs[2];
+    Graph graphs[2];
+    for (int fuse = 0; fuse < 2; ++fuse) {
+        Graph g = graphs[fuse] = make_ref<GraphObj>(runtime);
+        // The inner dimension spans more than one kernel block.
+        auto a = g->addTensor({3, 1, 300}, DataType::Float32);
+        auto b = g->addTensor({2, 300}, DataType::Float32);
+        auto x = g->addTensor({3, 2, 300}, DataType::Float32);
+        outputs[fuse] = buildChain(g, a, b, x);
+        if (fuse) {
+            EXPECT_TRUE(g->fuseElementWise());
+            ASSERT_EQ(g->getOperators().size(), 1u);
+            auto op = g->getOperators()[0];
+            EXPECT_EQ(op->getOpType(), OpType::FusedElementWise);
+            EXPECT_EQ(op->getInputs().size(), 3u);
+            EXPECT_EQ(op->getOutput(), outputs[fuse]);
+            EXPECT_EQ(g->getTensors().size(), 4u);
+            EXPECT_TRUE(g->checkValid());
+            EXPECT_FALSE(g->fuseElementWise());
+        }
+        g->dataMalloc();
+        a->setData(IncrementalGenerator());
+        b->setData(IncrementalGenerator());
+        x->setData(IncrementalGenerator());
+        runtime->run(g);
+    }
+    EXPECT_TRUE(outputs[1]->equalData(outputs[0]));
+}
+
+TEST(FusedElementWise, KeepsSharedIntermediates) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto a = g->addTensor({4, 4}, DataType::Float32);
+    auto b = g->addTensor({4, 4}, DataType::Float32);
+    auto add = g->addOp<AddObj>(a, b, nullptr);
+    // The sum is consumed twice, so it has to stay in memory.
+    auto relu = g->addOp<ReluObj>(add->getOutput(), nullptr);
+    auto mul = g->addOp<MulObj>(add->getOutput(), relu->getOutput(), nullptr);
+    EXPECT_TRUE(g->fuseElementWise());
+    EXPECT_EQ(g->getOperators().size(), 2u);
+    EXPECT_EQ(add->getOutput()->getTargets().size(), 1u);
+    EXPECT_EQ(mul->getOutput()->getSource()->getOpType(),
+              OpType::FusedElementWise);
+    EXPECT_TRUE(g->checkValid());
+}
+
+TEST(FusedElementWise, CutsTreesAtKernelLimits) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Tensor outputs[2];
+    Graph graphs[2];
+    for (int fuse = 0; fuse < 2; ++fuse) {
+        Graph g = graphs[fuse] = make_ref<GraphObj>(runtime);
+        // Sum of 21 inputs, which needs more than MaxInputs leaves.
+        TensorVec inputs{g->addTensor({4, 8}, DataType::Float32)};
+        Tensor sum = inputs[0];
+        for (int i = 0; i < 20; ++i) {
+            inputs.emplace_back(g->addTensor({4, 8}, DataType::Float32));
+            sum = g->addOp<AddObj>(sum, inputs.back(), nullptr)->getOutput();
+        }
+        outputs[fuse] = sum;
+        if (fuse) {
+            EXPECT_TRUE(g->fuseElementWise());
+            // Every Add is absorbed, in as few trees as the limits allow.
+            EXPECT_EQ(g->getOperators().size(), 3u);
+            for (const auto &op : g->getOperators()) {
+                EXPECT_EQ(op->getOpType(), OpType::FusedElementWise);
+                EXPECT_LE((int)op->getInputs().size(),
+                          FusedElementWiseObj::MaxInputs);
+            }
+            EXPECT_TRUE(g->checkValid());
+        }
+        g->dataMalloc();
+        for (const auto &input : inputs)
+            input->setData(IncrementalGenerator());
+        runtime->run(g);
+    }
+    EXPECT_TRUE(outputs[1]->equalData(outputs[0]));
+}
+
+TEST(FusedElementWise, LongChain) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({16}, DataType::Float32);
+    Tensor y = x;
+    for (int i = 0; i < 100000; ++i)
+        y = g->addOp<ReluObj>(y, nullptr)->getOutput();
+    EXPECT_TRUE(g->fuseElementWise());
+    ASSERT_EQ(g->getOperators().size(), 1u);
+    EXPECT_EQ(g->getOperators()[0]->getInputs(0), x);
+    EXPECT_EQ(g->getOperators()[0]->getOutput(), y);
+}
+
+} // namespace infini
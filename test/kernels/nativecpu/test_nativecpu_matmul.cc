@@ -0,0 +1,98 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini {
+
+// Runs every registered matmul candidate on the same op.
+void testMatmulCandidates(const Shape &shapeA, const Shape &shapeB, bool transA,
+                          bool transB, const vector<float> &ansVec) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto A = g->addTensor(shapeA, DataType::Float32);
+    auto B = g->addTensor(shapeB, DataType::Float32);
+    auto op = g->addOp<MatmulObj>(A, B, nullptr, transA, transB);
+    g->dataMalloc();
+    A->setData(IncrementalGenerator());
+    B->setData(IncrementalGenerator());
+
+    const auto &candidates = KernelRegistry::getInstance().getKernelItems(
+        KernelAttrs{Device::CPU, OpType::MatMul});
+    EXPECT_GT(candidates.size(), 1u);
+    for (const auto &candidate : candidates) {
+        op->getOutput()->setData(ZeroGenerator());
+        std::get<0>(candidate)->compute(op, runtime.get());
+        EXPECT_TRUE(op->getOutput()->equalData(ansVec))
+            << std::get<1>(candidate);
+    }
+}
+
+TEST(Matmul, NativeCpu) {
+    testMatmulCandidates(Shape{2, 3}, Shape{3, 2}, false, false,
+                         vector<float>{10, 13, 28, 40});
+    testMatmulCandidates(Shape{3, 2}, Shape{2, 3}, true, true,
+                         vector<float>{10, 28, 13, 40});
+    // Batch broadcast: B has a single batch.
+    testMatmulCandidates(Shape{2, 1, 2}, Shape{1, 2, 2}, false, false,
+                         vector<float>{2, 3, 6, 11});
+}
+
+// Builds Relu(bias + A * B), or Clip(bias + A * B, max = 600), with separate
+// ops and compares it with the epilogue-fused MatMul under every candidate.
+void testMatmulEpilogue(const Shape &shapeBias, bool relu) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Tensor outputs[2];
+    Graph graphs[2];
+    Operator matmul;
+    for (int fuse = 0; fuse < 2; ++fuse) {
+        Graph g = graphs[fuse] = make_ref<GraphObj>(runtime);
+        auto A = g->addTensor({2, 3, 5}, DataType::Float32);
+        auto B = g->addTensor({5, 4}, DataType::Float32);
+        auto bias = g->addTensor(shapeBias, DataType::Float32);
+        auto mm = g->addOp<MatmulObj>(A, B, nullptr);
+        auto add = g->addOp<AddObj>(bias, mm->getOutput(), nullptr);
+        Operator act =
+            relu ? (Operator)g->addOp<ReluObj>(add->getOutput(), nullptr)
+                 : (Operator)g->addOp<ClipObj>(add->getOutput(), nullptr,
+                                               std::nullopt, 600.f);
+        outputs[fuse] = act->getOutput();
+        if (fuse) {
+            EXPECT_TRUE(g->fuseMatmulEpilogue());
+            ASSERT_EQ(g->getOperators().size(), 1u);
+            EXPECT_EQ(mm->getOutput(), outputs[fuse]);
+            EXPECT_EQ(mm->getBias(), bias);
+            EXPECT_EQ(g->getTensors().size(), 4u);
+            EXPECT_TRUE(g->checkValid());
+            matmul = mm;
+        }
+        g->dataMalloc();
+        A->setData(IncrementalGenerator());
+        B->setData(IncrementalGenerator());
+        bias->setData([](void *ptr, size_t size, DataType) {
+            for (size_t i = 0; i < size; ++i)
+                reinterpret_cast<float *>(ptr)[i] = i * 7.f - 200.f;
+        });
+        runtime->run(g);
+    }
+    EXPECT_TRUE(outputs[1]->equalData(outputs[0]));
+
+    for (const auto &candidate : KernelRegistry::getInstance().getKernelItems(
+             KernelAttrs{Device::CPU, OpType::MatMul})) {
+        outputs[1]->setData(ZeroGenerator());
+        std::get<0>(candidate)->compute(matmul, runtime.get());
+        EXPECT_TRUE(outputs[1]->equalData(outputs[0]))
+            << std::get<1>(candidate);
+    }
+}
+
+TEST(Matmul, NativeCpuEpilogue) {
+    testMatmulEpilogue(Shape{4}, true);
+    testMatmulEpilogue(Shape{1, 1}, false);
+}
+
+} // namespace infini
@@ -24,4 +24,28 @@ TEST(Transpose, NativeCpu) {
                                                           8, 9, 10, 11, 20, 21, 22, 23}));
 }
 
+TEST(Transpose, NativeCpuCandidates) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto input = g->addTensor({3, 70, 40}, DataType::Float32);
+    auto op = g->addOp<TransposeObj>(input, nullptr, Shape{2, 0, 1});
+    g->dataMalloc();
+    input->setData(IncrementalGenerator());
+
+    vector<float> ans(input->size());
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 70; ++j)
+            for (int k = 0; k < 40; ++k)
+                ans[k * 3 * 70 + i * 70 + j] = i * 70 * 40 + j * 40 + k;
+
+    const auto &candidates = KernelRegistry::getInstance().getKernelItems(
+        KernelAttrs{Device::CPU, OpType::Transpose});
+    EXPECT_GT(candidates.size(), 1u);
+    for (const auto &candidate : candidates) {
+        op->getOutput()->setData(ZeroGenerator());
+        std::get<0>(candidate)->compute(op, runtime.get());
+        EXPECT_TRUE(op->getOutput()->equalData(ans)) << std::get<1>(candidate);
+    }
+}
+
 } // namespace infini